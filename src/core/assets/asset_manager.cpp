@@ -1,10 +1,30 @@
 #include "core/assets/asset_manager.hpp"
+#include "core/common/metrics.hpp"
+#include "core/common/parallel_for.hpp"
 #include "core/content/tile.hpp"
 #include <iostream>
+#include <set>
 
 namespace deepbound
 {
 
+namespace
+{
+struct asset_metrics_t
+{
+  metric_counter_t &uv_hits = metrics_t::get().counter("deepbound_texture_lookups_total", "Atlas UV lookups by result", {{"result", "hit"}});
+  metric_counter_t &uv_fallbacks = metrics_t::get().counter("deepbound_texture_lookups_total", "Atlas UV lookups by result", {{"result", "fallback"}});
+  metric_counter_t &textures_loaded = metrics_t::get().counter("deepbound_textures_loaded_total", "Textures packed into atlases");
+  metric_gauge_t &memory = metrics_t::get().gauge("deepbound_memory_bytes", "Approximate memory use per subsystem", {{"subsystem", "texture_atlases"}});
+};
+
+auto asset_metrics() -> asset_metrics_t &
+{
+  static asset_metrics_t metrics;
+  return metrics;
+}
+} // namespace
+
 auto asset_manager_t::get() -> asset_manager_t &
 {
   static asset_manager_t instance;
@@ -16,6 +36,7 @@ auto asset_manager_t::initialize() -> void
   // Always create at least the "tiles" and "items" atlases
   m_atlases["tiles"] = std::make_unique<texture_atlas_t>(2048, 2048);
   m_atlases["items"] = std::make_unique<texture_atlas_t>(2048, 2048);
+  asset_metrics().memory.set(2.0 * 2048 * 2048 * 4); // RGBA8
 
   // Register the fallback texture
   // Assuming the user's path provided: assets/textures/unknown.png
@@ -47,9 +68,11 @@ auto asset_manager_t::get_texture_uvs(const std::string &atlas_name, const resou
   // Checking for "missing" UV (stub implementation returns 0s for now)
   if (uvs.u1 == 0 && uvs.v1 == 0 && uvs.u2 == 0 && uvs.v2 == 0)
   {
+    asset_metrics().uv_fallbacks.add();
     return it->second->get_uvs(m_fallback_id);
   }
 
+  asset_metrics().uv_hits.add();
   return uvs;
 }
 
@@ -60,27 +83,41 @@ auto asset_manager_t::get_atlas_texture(const std::string &atlas_name) -> const
 
 auto asset_manager_t::load_all_textures_from_registry() -> void
 {
+  upload_textures(decode_textures_from_registry());
+}
+
+auto asset_manager_t::decode_textures_from_registry() const -> std::vector<pending_texture_t>
+{
+  // Collect every referenced texture once (many tile variants share textures)
+  std::vector<pending_texture_t> textures;
+  std::vector<std::string> paths;
+  std::set<resource_id_t> seen;
+  auto add = [&](const resource_id_t &id, const std::string &path)
+  {
+    if (seen.insert(id).second)
+    {
+      textures.push_back({"tiles", id, {}, false});
+      paths.push_back(path);
+    }
+  };
+
   // Access registries
   const auto &tiles = tile_registry_t::get().get_all_tiles();
 
   for (const auto &[id, def] : tiles)
   {
-    if (def.textures.empty())
-      continue;
-
+    // Constructed path: assets/textures/path.png (Flattened structure)
     for (const auto &[key, tex_id] : def.textures)
-    {
-      // Construct file path
-      // Constructed path: assets/textures/path.png (Flattened structure)
-      std::string path = "assets/textures/" + tex_id.get_path() + ".png";
-      register_texture("tiles", tex_id, path);
-    }
+      add(tex_id, "assets/textures/" + tex_id.get_path() + ".png");
 
     // Load special second texture if present
     if (!def.special_second_texture.get_path().empty() && def.special_second_texture.get_path() != "deepbound:unknown")
+      add(def.special_second_texture, "assets/textures/" + def.special_second_texture.get_path() + ".png");
+
+    for (const auto &variant : def.autotile_variants)
     {
-      std::string path = "assets/textures/" + def.special_second_texture.get_path() + ".png";
-      register_texture("tiles", def.special_second_texture, path);
+      if (!variant.get_path().empty())
+        add(variant, "assets/textures/" + variant.get_path() + ".png");
     }
   }
 
@@ -88,10 +125,27 @@ auto asset_manager_t::load_all_textures_from_registry() -> void
   for (const auto &[code, info] : m_color_maps)
   {
     if (info.load_into_atlas)
+      add(info.id, "assets/" + info.id.get_path() + ".png");
+  }
+
+  // Decode in parallel, interleaved so large and small files spread evenly
+  parallel_for(textures.size(), [&](size_t i) { textures[i].decoded = decode_image(paths[i], textures[i].image); });
+
+  return textures;
+}
+
+auto asset_manager_t::upload_textures(const std::vector<pending_texture_t> &textures) -> void
+{
+  for (const auto &t : textures)
+  {
+    auto it = m_atlases.find(t.atlas);
+    if (it == m_atlases.end())
     {
-      std::string path = "assets/" + info.id.get_path() + ".png";
-      register_texture("tiles", info.id, path);
+      std::cerr << "Atlas not found: " << t.atlas << std::endl;
+      continue;
     }
+    if (t.decoded && it->second->add_image(t.id, t.image))
+      asset_metrics().textures_loaded.add();
   }
 }
 
@@ -6,6 +6,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace deepbound
 {
@@ -37,6 +38,19 @@ public:
   // Loads all textures referenced by registered content
   auto load_all_textures_from_registry() -> void;
 
+  // The two halves of load_all_textures_from_registry, for overlapping startup work.
+  // Decoding is CPU only (files are decoded in parallel) and may run on any thread once content
+  // is registered; uploading packs the results into the atlases and needs the GL context.
+  struct pending_texture_t
+  {
+    std::string atlas;
+    resource_id_t id;
+    decoded_image_t image;
+    bool decoded = false;
+  };
+  auto decode_textures_from_registry() const -> std::vector<pending_texture_t>;
+  auto upload_textures(const std::vector<pending_texture_t> &textures) -> void;
+
   // Loads or retrieves a standalone texture
   auto get_texture(const resource_id_t &id) -> const texture_t &;
 
@@ -1,6 +1,9 @@
 #include "core/assets/json_loader.hpp"
+#include "core/content/autotile.hpp"
 #include "core/content/tile.hpp"
+#include "core/content/tile_behavior.hpp"
 // #include "core/worldgen/world_gen_context.hpp"
+#include "core/common/parallel_for.hpp"
 #include "core/common/resource_id.hpp"
 #include "core/assets/asset_manager.hpp"
 #include "core/worldgen/world_generator.hpp"
@@ -12,6 +15,8 @@
 
 #include <regex>
 #include <functional>
+#include <algorithm>
+#include <sstream>
 
 namespace deepbound
 {
@@ -49,26 +54,50 @@ auto json_loader_t::load_tiles_from_directory(const std::string &directory_path)
   }
 
   // Use recursive_directory_iterator to find tiles in subdirectories (stone, soil, liquid, etc)
+  std::vector<std::filesystem::path> files;
   for (const auto &entry : std::filesystem::recursive_directory_iterator(directory_path))
   {
     if (entry.is_regular_file() && entry.path().extension() == ".json")
-    {
-      std::ifstream f(entry.path());
-      if (!f.is_open())
-        continue;
-      std::stringstream buffer;
-      buffer << f.rdbuf();
-      parse_and_register_tile(buffer.str(), entry.path().filename().string());
-    }
+      files.push_back(entry.path());
+  }
+
+  // Reading and parsing (mostly standardize_json's regexes) runs in parallel; registration stays
+  // sequential and in directory order since the registry isn't thread safe
+  std::vector<nlohmann::json> parsed(files.size());
+  std::vector<char> ok(files.size(), 0);
+  parallel_for(files.size(),
+               [&](size_t i)
+               {
+                 std::ifstream f(files[i]);
+                 if (!f.is_open())
+                   return;
+                 std::stringstream buffer;
+                 buffer << f.rdbuf();
+                 try
+                 {
+                   parsed[i] = nlohmann::json::parse(standardize_json(buffer.str()), nullptr, true, true);
+                   ok[i] = 1;
+                 }
+                 catch (const std::exception &e)
+                 {
+                   std::cerr << "Failed to parse tile " << files[i].filename().string() << ": " << e.what() << std::endl;
+                 }
+               });
+
+  for (size_t i = 0; i < files.size(); i++)
+  {
+    if (ok[i])
+      register_tile_json(parsed[i], files[i].filename().string());
   }
+
+  // Behaviour names can only be resolved once every tile is known
+  tile_behavior_registry_t::get().compile();
 }
 
-auto json_loader_t::parse_and_register_tile(const std::string &json_content, const std::string &filename) -> void
+auto json_loader_t::register_tile_json(const nlohmann::json &j, const std::string &filename) -> void
 {
   try
   {
-    auto j = nlohmann::json::parse(standardize_json(json_content), nullptr, true, true);
-
     tile_definition_t base_def;
     base_def.code = j.value("code", "unknown");
     base_def.id = resource_id_t("deepbound", base_def.code);
@@ -119,6 +148,51 @@ auto json_loader_t::parse_and_register_tile(const std::string &json_content, con
       base_def.climate_color_map = j["climateColorMap"].get<std::string>();
     }
 
+    // "behaviors": [{ "name": "UnstableFalling" }] or plain names, resolved by tile_behavior_registry_t::compile()
+    if (j.contains("behaviors"))
+    {
+      for (const auto &val : j["behaviors"])
+      {
+        if (val.is_string())
+          base_def.behaviors.push_back(val.get<std::string>());
+        else if (val.contains("name"))
+          base_def.behaviors.push_back(val["name"].get<std::string>());
+      }
+    }
+
+    // "autotile": { "group": "soil", "connectivity": 8, "variants": "tile/soil/edge/{variant}" }
+    // variants is a path pattern or an object of variant index -> path; missing ones use the base texture
+    if (j.contains("autotile"))
+    {
+      const auto &a = j["autotile"];
+      base_def.autotile_group = tile_registry_t::get().get_autotile_group(a.value("group", base_def.code));
+      base_def.autotile_connectivity = a.value("connectivity", 4) == 8 ? 8 : 4;
+
+      if (a.contains("variants"))
+      {
+        const auto &v = a["variants"];
+        base_def.autotile_variants.resize(autotile_variant_count(base_def.autotile_connectivity));
+        for (int i = 0; i < (int)base_def.autotile_variants.size(); i++)
+        {
+          std::string path;
+          if (v.is_string())
+          {
+            path = v.get<std::string>();
+            size_t pos = path.find("{variant}");
+            if (pos != std::string::npos)
+              path.replace(pos, 9, std::to_string(i));
+          }
+          else if (v.contains(std::to_string(i)))
+          {
+            path = v[std::to_string(i)].get<std::string>();
+          }
+
+          if (!path.empty())
+            base_def.autotile_variants[i] = resource_id_t("deepbound", path);
+        }
+      }
+    }
+
     // Determine variants
     struct variant_group_t
     {
@@ -191,6 +265,25 @@ auto json_loader_t::parse_and_register_tile(const std::string &json_content, con
             var.special_second_texture = resource_id_t("deepbound", p);
           }
 
+          // Same for autotile variants
+          for (auto &variant : var.autotile_variants)
+          {
+            if (variant.get_path().empty())
+              continue;
+            std::string p = variant.get_path();
+            for (const auto &rep : replacements)
+            {
+              std::string ph = "{" + rep.first + "}";
+              size_t pos = 0;
+              while ((pos = p.find(ph, pos)) != std::string::npos)
+              {
+                p.replace(pos, ph.length(), rep.second);
+                pos += rep.second.length();
+              }
+            }
+            variant = resource_id_t("deepbound", p);
+          }
+
           // Helper to check wildcard match for specific properties
           auto check_map_property = [&](const nlohmann::json &json_map, const std::string &suffix) -> std::string
           {
@@ -3,6 +3,7 @@
 #include "core/content/tile.hpp"
 #include <string>
 #include <vector>
+#include <nlohmann/json.hpp>
 
 namespace deepbound
 {
@@ -10,6 +11,9 @@ namespace deepbound
 // Forward declaration
 class world_gen_context_t;
 
+// Turns loose JSON (// comments, trailing commas, unquoted keys) into strict JSON
+auto standardize_json(const std::string &input) -> std::string;
+
 class json_loader_t
 {
 public:
@@ -19,8 +23,8 @@ public:
   static auto load_worldgen(const std::string &base_dir, world_gen_context_t &context) -> void;
 
 private:
-  // Now returns void because it registers internally
-  static auto parse_and_register_tile(const std::string &json_content, const std::string &filename) -> void;
+  // Registers a parsed tile file, expanding its variants
+  static auto register_tile_json(const nlohmann::json &j, const std::string &filename) -> void;
   static auto parse_strata_json(const std::string &json_content) -> void;
 };
 
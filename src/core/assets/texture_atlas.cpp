@@ -88,7 +88,7 @@ texture_atlas_t::texture_atlas_t(int width, int height) : m_width(width), m_heig
   m_row_height = 0;
 }
 
-auto texture_atlas_t::add_texture(const resource_id_t &id, const std::string &file_path) -> bool
+auto decode_image(const std::string &file_path, decoded_image_t &out) -> bool
 {
   int width, height, nrChannels;
   unsigned char *data = stbi_load(file_path.c_str(), &width, &height, &nrChannels, 4); // Force 4 channels (RGBA)
@@ -99,6 +99,26 @@ auto texture_atlas_t::add_texture(const resource_id_t &id, const std::string &fi
     return false;
   }
 
+  out.width = width;
+  out.height = height;
+  out.pixels.assign(data, data + (size_t)width * height * 4);
+  stbi_image_free(data);
+  return true;
+}
+
+auto texture_atlas_t::add_texture(const resource_id_t &id, const std::string &file_path) -> bool
+{
+  decoded_image_t image;
+  if (!decode_image(file_path, image))
+    return false;
+  return add_image(id, image);
+}
+
+auto texture_atlas_t::add_image(const resource_id_t &id, const decoded_image_t &image) -> bool
+{
+  const int width = image.width;
+  const int height = image.height;
+
   // Simple packing: fill row, move to next
   if (m_current_x + width > m_width)
   {
@@ -109,8 +129,7 @@ auto texture_atlas_t::add_texture(const resource_id_t &id, const std::string &fi
 
   if (m_current_y + height > m_height)
   {
-    std::cerr << "Texture atlas full! Cannot add " << file_path << std::endl;
-    stbi_image_free(data);
+    std::cerr << "Texture atlas full! Cannot add " << id << std::endl;
     return false;
   }
 
@@ -120,7 +139,7 @@ auto texture_atlas_t::add_texture(const resource_id_t &id, const std::string &fi
 
   // Upload sub-image
   glBindTexture(GL_TEXTURE_2D, m_texture.m_id);
-  glTexSubImage2D(GL_TEXTURE_2D, 0, m_current_x, m_current_y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, m_current_x, m_current_y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels.data());
 
   // Calculate UVs
   // UV coordinates are normalized [0, 1]
@@ -134,8 +153,6 @@ auto texture_atlas_t::add_texture(const resource_id_t &id, const std::string &fi
 
   // Advance cursor
   m_current_x += width;
-
-  stbi_image_free(data);
   return true;
 }
 
@@ -13,6 +13,16 @@ struct uv_rect_t
   float u1, v1, u2, v2;
 };
 
+// RGBA8 pixels decoded from an image file; needs no GL context
+struct decoded_image_t
+{
+  int width = 0;
+  int height = 0;
+  std::vector<unsigned char> pixels;
+};
+
+auto decode_image(const std::string &file_path, decoded_image_t &out) -> bool;
+
 class texture_t
 {
 public:
@@ -51,6 +61,12 @@ public:
 
   // Adds a texture to the atlas and returns its UVs
   auto add_texture(const resource_id_t &id, const std::string &file_path) -> bool;
+  // Same for an image decoded elsewhere (e.g. on a loader thread); only this part touches GL
+  auto add_image(const resource_id_t &id, const decoded_image_t &image) -> bool;
+  auto contains(const resource_id_t &id) const -> bool
+  {
+    return m_uv_map.count(id) != 0;
+  }
 
   // Gets UVs for a registered texture
   auto get_uvs(const resource_id_t &id) const -> uv_rect_t;
@@ -0,0 +1,241 @@
+#include "core/common/async_io.hpp"
+#include "core/common/metrics.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <iterator>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace deepbound
+{
+
+namespace
+{
+struct io_metrics_t
+{
+  metric_counter_t &written_bytes = metrics_t::get().counter("deepbound_save_written_bytes_total", "Bytes written by the save I/O threads");
+  metric_counter_t &failures = metrics_t::get().counter("deepbound_save_failures_total", "Save batches that failed to write or sync");
+  metric_gauge_t &queued_bytes = metrics_t::get().gauge("deepbound_save_queued_bytes", "Save data queued and not written yet");
+  metric_histogram_t &batch_seconds = metrics_t::get().histogram("deepbound_save_batch_seconds", "Write and fsync of one batch", metrics_t::seconds_buckets());
+};
+
+io_metrics_t &io_metrics()
+{
+  static io_metrics_t metrics;
+  return metrics;
+}
+
+auto sync_file(FILE *file) -> bool
+{
+#ifdef _WIN32
+  return _commit(_fileno(file)) == 0;
+#else
+  return fsync(fileno(file)) == 0;
+#endif
+}
+} // namespace
+
+async_io_t::async_io_t(int threads, size_t bytes_per_second) : m_bytes_per_second(bytes_per_second), m_next_write(std::chrono::steady_clock::now())
+{
+  for (int i = 0; i < std::max(1, threads); i++)
+    m_threads.emplace_back([this]() { worker(); });
+}
+
+async_io_t::~async_io_t()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_work.notify_all();
+  for (auto &thread : m_threads)
+    thread.join();
+}
+
+auto async_io_t::append(const std::string &path, std::vector<uint8_t> data, completion_t done) -> void
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.queued_bytes += data.size();
+    io_metrics().queued_bytes.set((double)m_stats.queued_bytes);
+    m_files[path].writes.push_back({std::move(data), std::move(done), {}});
+  }
+  m_work.notify_one();
+}
+
+auto async_io_t::run_exclusive(const std::string &path, std::function<void()> task) -> void
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_files[path].writes.push_back({{}, {}, std::move(task)});
+  }
+  m_work.notify_one();
+}
+
+auto async_io_t::write_file(const std::string &path, const std::vector<uint8_t> &data) -> bool
+{
+  FILE *file = std::fopen(path.c_str(), "wb");
+  if (!file)
+    return false;
+  bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+  ok = std::fflush(file) == 0 && ok;
+  ok = sync_file(file) && ok;
+  std::fclose(file);
+  return ok;
+}
+
+auto async_io_t::flush() -> void
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_flushing++;
+  m_work.notify_all();
+  m_idle.wait(lock, [this]() { return m_files.empty(); });
+  m_flushing--;
+}
+
+auto async_io_t::set_throttle(size_t bytes_per_second) -> void
+{
+  m_bytes_per_second = bytes_per_second;
+}
+
+auto async_io_t::get_stats() const -> stats_t
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_stats;
+}
+
+auto async_io_t::worker() -> void
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true)
+  {
+    auto it = std::find_if(m_files.begin(), m_files.end(), [](const auto &file) { return !file.second.busy && !file.second.writes.empty(); });
+    if (it == m_files.end())
+    {
+      // Only exits once everything queued before shutdown is on disk
+      if (m_stopping && m_files.empty())
+        return;
+      m_work.wait(lock);
+      continue;
+    }
+
+    // Take everything queued for this file up to the next exclusive task as one batch, or the task
+    const std::string path = it->first;
+    auto &writes = it->second.writes;
+    auto split = std::find_if(writes.begin(), writes.end(), [](const write_t &write) { return (bool)write.task; });
+    if (split == writes.begin())
+      split++;
+    std::vector<write_t> batch(std::make_move_iterator(writes.begin()), std::make_move_iterator(split));
+    writes.erase(writes.begin(), split);
+    it->second.busy = true;
+    const bool urgent = m_stopping || m_flushing > 0;
+    lock.unlock();
+
+    if (batch.front().task)
+    {
+      batch.front().task();
+      lock.lock();
+    }
+    else
+    {
+      size_t bytes = 0;
+      for (const auto &write : batch)
+        bytes += write.data.size();
+      if (!urgent)
+        throttle(bytes);
+      bool ok = write_batch(path, batch);
+
+      lock.lock();
+      m_stats.queued_bytes -= bytes;
+      m_stats.written_bytes += ok ? bytes : 0;
+      m_stats.batches++;
+      m_stats.failures += ok ? 0 : 1;
+      io_metrics().queued_bytes.set((double)m_stats.queued_bytes);
+    }
+
+    auto &file = m_files[path];
+    file.busy = false;
+    if (!file.writes.empty())
+      m_work.notify_one(); // Queued while we were writing
+    else
+    {
+      m_files.erase(path);
+      if (m_stopping)
+        m_work.notify_all(); // Threads waiting for the last batch to exit
+    }
+    m_idle.notify_all();
+  }
+}
+
+auto async_io_t::write_batch(const std::string &path, std::vector<write_t> &batch) -> bool
+{
+  metric_timer_t timer(io_metrics().batch_seconds);
+
+  FILE *file = std::fopen(path.c_str(), "ab");
+  bool ok = file != nullptr;
+  uint64_t offset = 0;
+  if (ok)
+  {
+    std::fseek(file, 0, SEEK_END);
+    long end = std::ftell(file);
+    ok = end >= 0;
+    offset = ok ? (uint64_t)end : 0;
+  }
+
+  std::vector<uint64_t> offsets;
+  offsets.reserve(batch.size());
+  for (const auto &write : batch)
+  {
+    offsets.push_back(offset);
+    if (ok)
+      ok = std::fwrite(write.data.data(), 1, write.data.size(), file) == write.data.size();
+    offset += write.data.size();
+  }
+
+  // One sync for the whole batch
+  if (file)
+  {
+    ok = std::fflush(file) == 0 && ok;
+    ok = sync_file(file) && ok;
+    std::fclose(file);
+  }
+
+  if (ok)
+    io_metrics().written_bytes.add(offset - offsets.front());
+  else
+  {
+    io_metrics().failures.add();
+    std::cerr << "Failed to write " << path << std::endl;
+  }
+
+  for (size_t i = 0; i < batch.size(); i++)
+  {
+    if (batch[i].done)
+      batch[i].done(ok, offsets[i]);
+  }
+  return ok;
+}
+
+auto async_io_t::throttle(size_t bytes) -> void
+{
+  size_t rate = m_bytes_per_second;
+  if (rate == 0)
+    return;
+
+  // Token bucket shared by all threads: each batch pushes the next one back by its own size
+  std::chrono::steady_clock::time_point start;
+  {
+    std::lock_guard<std::mutex> lock(m_throttle_mutex);
+    auto now = std::chrono::steady_clock::now();
+    start = std::max(now, m_next_write);
+    m_next_write = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>((double)bytes / rate));
+  }
+  std::this_thread::sleep_until(start);
+}
+
+} // namespace deepbound
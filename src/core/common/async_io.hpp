@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace deepbound
+{
+
+/**
+ * @brief Background file writer for saves. The main thread queues appends and never waits on the disk.
+ *
+ * A small pool of I/O threads drains the queue. Appends to one file are written in the order they
+ * were queued and in batches: everything queued for a file when a thread picks it up goes out in
+ * one pass followed by a single fsync, so an autosave of many chunks costs one sync per region file
+ * rather than one per chunk. A throttle caps the write rate so a large autosave doesn't compete with
+ * chunk streaming for the disk; flush() and shutdown ignore it.
+ */
+class async_io_t
+{
+public:
+  // Runs on an I/O thread once the data is synced. `offset` is where it starts in the file.
+  using completion_t = std::function<void(bool ok, uint64_t offset)>;
+
+  struct stats_t
+  {
+    size_t queued_bytes = 0; // Not written yet
+    uint64_t written_bytes = 0;
+    uint64_t batches = 0; // = fsyncs
+    uint64_t failures = 0;
+  };
+
+  // bytes_per_second 0 = unthrottled
+  explicit async_io_t(int threads = 2, size_t bytes_per_second = 16ull * 1024 * 1024);
+  ~async_io_t(); // Writes everything still queued
+
+  async_io_t(const async_io_t &) = delete;
+  async_io_t &operator=(const async_io_t &) = delete;
+
+  auto append(const std::string &path, std::vector<uint8_t> data, completion_t done = {}) -> void;
+
+  // Runs `task` on an I/O thread once everything queued for the file before it is written, and
+  // before anything queued after it starts, so it has the file to itself (to index or rewrite it).
+  // Not throttled.
+  auto run_exclusive(const std::string &path, std::function<void()> task) -> void;
+
+  // Writes and syncs a whole file, replacing any previous contents. For run_exclusive tasks.
+  static auto write_file(const std::string &path, const std::vector<uint8_t> &data) -> bool;
+
+  // Blocks until everything queued so far is written and synced
+  auto flush() -> void;
+
+  auto set_throttle(size_t bytes_per_second) -> void;
+  auto get_stats() const -> stats_t;
+
+private:
+  struct write_t
+  {
+    std::vector<uint8_t> data;
+    completion_t done;
+    std::function<void()> task; // Set for run_exclusive, which runs alone instead of writing
+  };
+  struct file_queue_t
+  {
+    std::vector<write_t> writes;
+    bool busy = false; // A thread is writing a batch, the next one waits so order holds
+  };
+
+  auto worker() -> void;
+  auto write_batch(const std::string &path, std::vector<write_t> &batch) -> bool;
+  auto throttle(size_t bytes) -> void;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_work; // Writes queued, or stopping
+  std::condition_variable m_idle; // A batch finished
+  std::map<std::string, file_queue_t> m_files;
+  stats_t m_stats;
+  bool m_stopping = false;
+  int m_flushing = 0;
+
+  std::atomic<size_t> m_bytes_per_second;
+  std::mutex m_throttle_mutex;
+  std::chrono::steady_clock::time_point m_next_write; // Earliest start of the next throttled batch
+
+  std::vector<std::thread> m_threads;
+};
+
+} // namespace deepbound
@@ -0,0 +1,76 @@
+#include "core/common/input_recording.hpp"
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+namespace deepbound
+{
+
+auto input_recording_t::is_down(const input_frame_t &frame, int key_code) const -> bool
+{
+  for (size_t i = 0; i < keys.size() && i < 32; i++)
+  {
+    if (keys[i] == key_code)
+      return (frame.keys >> i) & 1u;
+  }
+  return false;
+}
+
+auto input_recording_t::save(const std::string &path) const -> bool
+{
+  std::ofstream file(path);
+  if (!file.is_open())
+  {
+    std::cerr << "Failed to write input recording: " << path << std::endl;
+    return false;
+  }
+
+  nlohmann::json j;
+  j["version"] = 1;
+  j["seed"] = seed;
+  j["keys"] = keys;
+  j["start_position"] = {start_position.x, start_position.y};
+  j["start_zoom"] = start_zoom;
+
+  // One compact [dt, keys, scroll] triple per frame
+  auto &out = j["frames"] = nlohmann::json::array();
+  for (const auto &f : frames)
+    out.push_back({f.delta_time, f.keys, f.scroll});
+
+  file << j.dump();
+  return true;
+}
+
+auto input_recording_t::load(const std::string &path) -> bool
+{
+  std::ifstream file(path);
+  if (!file.is_open())
+  {
+    std::cerr << "Failed to open input recording: " << path << std::endl;
+    return false;
+  }
+
+  try
+  {
+    nlohmann::json j;
+    file >> j;
+
+    seed = j.value("seed", 0);
+    keys = j.value("keys", std::vector<int>{});
+    if (j.contains("start_position"))
+      start_position = {j["start_position"][0].get<float>(), j["start_position"][1].get<float>()};
+    start_zoom = j.value("start_zoom", 1.0f);
+
+    frames.clear();
+    for (const auto &f : j["frames"])
+      frames.push_back({f[0].get<float>(), f[1].get<uint32_t>(), f[2].get<float>()});
+  }
+  catch (const std::exception &e)
+  {
+    std::cerr << "Failed to parse input recording " << path << ": " << e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace deepbound
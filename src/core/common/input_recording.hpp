@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace deepbound
+{
+
+struct input_frame_t
+{
+  float delta_time = 0.0f; // Simulation step used for this frame
+  uint32_t keys = 0;       // Bit i = input_recording_t::keys[i] held
+  float scroll = 0.0f;     // Summed scroll wheel offset
+};
+
+/**
+ * @brief Per-frame input stream of a play session, replayable frame for frame.
+ *
+ * Replays feed the recorded delta times to the simulation instead of the wall clock and start
+ * from the recorded seed and camera, so two builds fly exactly the same path through the same
+ * world. Stored as JSON.
+ */
+struct input_recording_t
+{
+  int seed = 0;
+  std::vector<int> keys; // Tracked key codes
+  glm::vec2 start_position{0.0f, 0.0f};
+  float start_zoom = 1.0f;
+  std::vector<input_frame_t> frames;
+
+  auto is_down(const input_frame_t &frame, int key_code) const -> bool;
+  // Bit mask of `keys` for a frame, given a "is this key held" query
+  template <typename F>
+  auto pack_keys(F &&is_pressed) const -> uint32_t
+  {
+    uint32_t bits = 0;
+    for (size_t i = 0; i < keys.size() && i < 32; i++)
+    {
+      if (is_pressed(keys[i]))
+        bits |= 1u << i;
+    }
+    return bits;
+  }
+
+  auto save(const std::string &path) const -> bool;
+  auto load(const std::string &path) -> bool;
+};
+
+} // namespace deepbound
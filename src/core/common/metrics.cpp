@@ -0,0 +1,353 @@
+#include "core/common/metrics.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+
+namespace deepbound
+{
+
+namespace metrics_detail
+{
+auto shard_index() -> size_t
+{
+  static std::atomic<size_t> next{0};
+  thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+  return index;
+}
+} // namespace metrics_detail
+
+namespace
+{
+auto escape_label(const std::string &value) -> std::string
+{
+  std::string out;
+  for (char c : value)
+  {
+    if (c == '\\' || c == '"')
+      out += '\\';
+    if (c == '\n')
+    {
+      out += "\\n";
+      continue;
+    }
+    out += c;
+  }
+  return out;
+}
+
+// Inner part of {...}, e.g. subsystem="chunks"
+auto render_labels(const metric_labels_t &labels) -> std::string
+{
+  std::string out;
+  for (const auto &[key, value] : labels)
+  {
+    if (!out.empty())
+      out += ',';
+    out += key + "=\"" + escape_label(value) + "\"";
+  }
+  return out;
+}
+
+auto with_labels(const std::string &name, const std::string &labels, const std::string &extra = "") -> std::string
+{
+  std::string all = labels;
+  if (!extra.empty())
+    all += (all.empty() ? "" : ",") + extra;
+  return all.empty() ? name : name + "{" + all + "}";
+}
+
+auto format_number(double v) -> std::string
+{
+  if (std::isinf(v))
+    return v > 0 ? "+Inf" : "-Inf";
+  char buffer[64];
+  std::snprintf(buffer, sizeof(buffer), "%.15g", v);
+  return buffer;
+}
+} // namespace
+
+auto metric_counter_t::value() const -> uint64_t
+{
+  uint64_t total = 0;
+  for (const auto &shard : m_shards)
+    total += shard.value.load(std::memory_order_relaxed);
+  return total;
+}
+
+metric_histogram_t::metric_histogram_t(std::vector<double> bounds) : m_bounds(std::move(bounds))
+{
+  std::sort(m_bounds.begin(), m_bounds.end());
+  for (auto &shard : m_shards)
+  {
+    shard.buckets = std::make_unique<std::atomic<uint64_t>[]>(m_bounds.size() + 1);
+    for (size_t i = 0; i <= m_bounds.size(); i++)
+      shard.buckets[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+auto metric_histogram_t::observe(double v) -> void
+{
+  // First bucket whose upper bound holds v; past the end is +Inf
+  size_t bucket = std::lower_bound(m_bounds.begin(), m_bounds.end(), v) - m_bounds.begin();
+  auto &shard = m_shards[metrics_detail::shard_index()];
+  shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  shard.sum.fetch_add(v, std::memory_order_relaxed);
+  shard.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto metric_histogram_t::snapshot() const -> snapshot_t
+{
+  snapshot_t snap;
+  snap.bounds = m_bounds;
+  snap.cumulative.assign(m_bounds.size() + 1, 0);
+  for (const auto &shard : m_shards)
+  {
+    for (size_t i = 0; i <= m_bounds.size(); i++)
+      snap.cumulative[i] += shard.buckets[i].load(std::memory_order_relaxed);
+    snap.sum += shard.sum.load(std::memory_order_relaxed);
+    snap.count += shard.count.load(std::memory_order_relaxed);
+  }
+  for (size_t i = 1; i < snap.cumulative.size(); i++)
+    snap.cumulative[i] += snap.cumulative[i - 1];
+  // Shards are read one after another, keep the output self-consistent
+  snap.count = snap.cumulative.back();
+  return snap;
+}
+
+auto metrics_t::get() -> metrics_t &
+{
+  static metrics_t instance;
+  return instance;
+}
+
+auto metrics_t::get_family(const std::string &name, const std::string &help, type_e type) -> family_t &
+{
+  auto it = m_families.find(name);
+  if (it == m_families.end())
+    it = m_families.emplace(name, family_t{type, help, {}, {}, {}}).first;
+  else if (it->second.type != type)
+    std::cerr << "Metric " << name << " registered with two different types" << std::endl;
+  return it->second;
+}
+
+auto metrics_t::counter(const std::string &name, const std::string &help, const metric_labels_t &labels) -> metric_counter_t &
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto &slot = get_family(name, help, type_e::counter).counters[render_labels(labels)];
+  if (!slot)
+    slot = std::make_unique<metric_counter_t>();
+  return *slot;
+}
+
+auto metrics_t::gauge(const std::string &name, const std::string &help, const metric_labels_t &labels) -> metric_gauge_t &
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto &slot = get_family(name, help, type_e::gauge).gauges[render_labels(labels)];
+  if (!slot)
+    slot = std::make_unique<metric_gauge_t>();
+  return *slot;
+}
+
+auto metrics_t::histogram(const std::string &name, const std::string &help, const std::vector<double> &buckets, const metric_labels_t &labels) -> metric_histogram_t &
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto &slot = get_family(name, help, type_e::histogram).histograms[render_labels(labels)];
+  if (!slot)
+    slot = std::make_unique<metric_histogram_t>(buckets);
+  return *slot;
+}
+
+auto metrics_t::render_prometheus() const -> std::string
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::ostringstream out;
+  for (const auto &[name, family] : m_families)
+  {
+    const char *type = family.type == type_e::counter ? "counter" : (family.type == type_e::gauge ? "gauge" : "histogram");
+    out << "# HELP " << name << " " << family.help << "\n";
+    out << "# TYPE " << name << " " << type << "\n";
+
+    for (const auto &[labels, counter] : family.counters)
+      out << with_labels(name, labels) << " " << counter->value() << "\n";
+    for (const auto &[labels, gauge] : family.gauges)
+      out << with_labels(name, labels) << " " << format_number(gauge->value()) << "\n";
+    for (const auto &[labels, histogram] : family.histograms)
+    {
+      auto snap = histogram->snapshot();
+      for (size_t i = 0; i < snap.bounds.size(); i++)
+        out << with_labels(name + "_bucket", labels, "le=\"" + format_number(snap.bounds[i]) + "\"") << " " << snap.cumulative[i] << "\n";
+      out << with_labels(name + "_bucket", labels, "le=\"+Inf\"") << " " << snap.cumulative.back() << "\n";
+      out << with_labels(name + "_sum", labels) << " " << format_number(snap.sum) << "\n";
+      out << with_labels(name + "_count", labels) << " " << snap.count << "\n";
+    }
+  }
+  return out.str();
+}
+
+auto metrics_t::exponential_buckets(double start, double factor, int count) -> std::vector<double>
+{
+  std::vector<double> buckets;
+  for (int i = 0; i < count; i++, start *= factor)
+    buckets.push_back(start);
+  return buckets;
+}
+
+auto metrics_t::seconds_buckets() -> std::vector<double>
+{
+  return exponential_buckets(0.0001, 2.0, 15);
+}
+
+metrics_exporter_t::~metrics_exporter_t()
+{
+  stop();
+}
+
+auto metrics_exporter_t::start(int port, const std::string &dump_path, double interval_seconds) -> bool
+{
+  stop();
+  m_dump_path = dump_path;
+  m_interval_seconds = std::max(0.1, interval_seconds);
+
+  if (port > 0)
+  {
+#ifdef _WIN32
+    std::cerr << "Metrics endpoint is not supported on this platform, use the file dump" << std::endl;
+    return false;
+#else
+    m_listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int yes = 1;
+    setsockopt(m_listen_fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    // Localhost only: the endpoint is for soak runs on the same machine, not for exposing the game
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons((uint16_t)port);
+    if (m_listen_fd < 0 || bind(m_listen_fd, (sockaddr *)&addr, sizeof(addr)) != 0 || listen(m_listen_fd, 4) != 0)
+    {
+      std::cerr << "Failed to open metrics endpoint on 127.0.0.1:" << port << std::endl;
+      if (m_listen_fd >= 0)
+        close(m_listen_fd);
+      m_listen_fd = -1;
+      return false;
+    }
+    std::cout << "Metrics at http://127.0.0.1:" << port << "/metrics" << std::endl;
+#endif
+  }
+
+  m_running = true;
+  if (m_listen_fd >= 0)
+    m_http_thread = std::thread([this]() { serve(); });
+  if (!m_dump_path.empty())
+    m_dump_thread = std::thread([this]() { dump_loop(); });
+  return true;
+}
+
+auto metrics_exporter_t::stop() -> void
+{
+  {
+    std::lock_guard<std::mutex> lock(m_wake_mutex);
+    m_running = false;
+  }
+  m_wake.notify_all();
+  if (m_http_thread.joinable())
+    m_http_thread.join();
+  if (m_dump_thread.joinable())
+    m_dump_thread.join();
+#ifndef _WIN32
+  if (m_listen_fd >= 0)
+    close(m_listen_fd);
+#endif
+  m_listen_fd = -1;
+}
+
+auto metrics_exporter_t::serve() -> void
+{
+#ifndef _WIN32
+  while (m_running)
+  {
+    // Poll so stop() doesn't have to interrupt a blocking accept
+    pollfd pfd = {m_listen_fd, POLLIN, 0};
+    if (poll(&pfd, 1, 200) <= 0)
+      continue;
+
+    int client = accept(m_listen_fd, nullptr, nullptr);
+    if (client < 0)
+      continue;
+
+    // Only the request line matters; anything but GET /metrics is a 404
+    char request[1024] = {};
+    pollfd cfd = {client, POLLIN, 0};
+    ssize_t n = poll(&cfd, 1, 1000) > 0 ? recv(client, request, sizeof(request) - 1, 0) : 0;
+    std::string line(request, n > 0 ? (size_t)n : 0);
+    line = line.substr(0, line.find('\r'));
+
+    std::string status = "200 OK";
+    std::string body;
+    if (line.rfind("GET /metrics", 0) == 0)
+      body = metrics_t::get().render_prometheus();
+    else
+    {
+      status = "404 Not Found";
+      body = "Try /metrics\n";
+    }
+
+    std::string response = "HTTP/1.1 " + status +
+                           "\r\nContent-Type: text/plain; version=0.0.4\r\nConnection: close\r\nContent-Length: " + std::to_string(body.size()) +
+                           "\r\n\r\n" + body;
+    size_t sent = 0;
+    while (sent < response.size())
+    {
+      ssize_t w = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+      if (w <= 0)
+        break;
+      sent += (size_t)w;
+    }
+    close(client);
+  }
+#endif
+}
+
+auto metrics_exporter_t::dump_loop() -> void
+{
+  std::unique_lock<std::mutex> lock(m_wake_mutex);
+  while (m_running)
+  {
+    m_wake.wait_for(lock, std::chrono::duration<double>(m_interval_seconds), [this]() { return !m_running; });
+    lock.unlock();
+    write_dump(); // Also once on stop, so a soak run ends with final numbers
+    lock.lock();
+  }
+}
+
+auto metrics_exporter_t::write_dump() -> void
+{
+  // Write then rename, so readers never see a half-written file
+  std::string tmp = m_dump_path + ".tmp";
+  {
+    std::ofstream file(tmp);
+    if (!file.is_open())
+    {
+      std::cerr << "Failed to write metrics to " << m_dump_path << std::endl;
+      return;
+    }
+    file << metrics_t::get().render_prometheus();
+  }
+  std::rename(tmp.c_str(), m_dump_path.c_str());
+}
+
+} // namespace deepbound
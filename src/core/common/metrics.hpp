@@ -0,0 +1,196 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace deepbound
+{
+
+using metric_labels_t = std::vector<std::pair<std::string, std::string>>;
+
+namespace metrics_detail
+{
+constexpr size_t SHARDS = 16;
+
+// Each thread sticks to one shard, handed out round robin
+auto shard_index() -> size_t;
+} // namespace metrics_detail
+
+// Monotonic count. add() is a relaxed atomic add on the calling thread's shard, so hot paths on
+// different threads don't fight over one cache line.
+class metric_counter_t
+{
+public:
+  auto add(uint64_t n = 1) -> void
+  {
+    m_shards[metrics_detail::shard_index()].value.fetch_add(n, std::memory_order_relaxed);
+  }
+  auto value() const -> uint64_t;
+
+private:
+  struct alignas(64) shard_t
+  {
+    std::atomic<uint64_t> value{0};
+  };
+  std::array<shard_t, metrics_detail::SHARDS> m_shards;
+};
+
+// Current value of something (queue depth, bytes in use)
+class metric_gauge_t
+{
+public:
+  auto set(double v) -> void
+  {
+    m_value.store(v, std::memory_order_relaxed);
+  }
+  auto add(double v) -> void
+  {
+    m_value.fetch_add(v, std::memory_order_relaxed);
+  }
+  auto value() const -> double
+  {
+    return m_value.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<double> m_value{0.0};
+};
+
+// Distribution over fixed buckets (upper bounds, ascending), sharded like the counter
+class metric_histogram_t
+{
+public:
+  explicit metric_histogram_t(std::vector<double> bounds);
+
+  auto observe(double v) -> void;
+
+  struct snapshot_t
+  {
+    std::vector<double> bounds;
+    std::vector<uint64_t> cumulative; // Per bound, plus +Inf last
+    double sum = 0.0;
+    uint64_t count = 0;
+  };
+  auto snapshot() const -> snapshot_t;
+
+  auto get_bounds() const -> const std::vector<double> &
+  {
+    return m_bounds;
+  }
+
+private:
+  struct alignas(64) shard_t
+  {
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets;
+    std::atomic<double> sum{0.0};
+    std::atomic<uint64_t> count{0};
+  };
+
+  std::vector<double> m_bounds;
+  std::array<shard_t, metrics_detail::SHARDS> m_shards;
+};
+
+// Observes its own lifetime, in seconds, into a histogram
+class metric_timer_t
+{
+public:
+  explicit metric_timer_t(metric_histogram_t &histogram) : m_histogram(histogram), m_start(std::chrono::steady_clock::now())
+  {
+  }
+  ~metric_timer_t()
+  {
+    m_histogram.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count());
+  }
+
+private:
+  metric_histogram_t &m_histogram;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * @brief Process-wide registry of named metrics, rendered in Prometheus text format.
+ *
+ * Looking a metric up takes a lock, so callers fetch it once and keep the reference (metrics live
+ * as long as the registry): static auto &c = metrics_t::get().counter(...). Updating is lock free.
+ * Names follow Prometheus conventions: deepbound_ prefix, base units (seconds, bytes), _total on counters.
+ */
+class metrics_t
+{
+public:
+  static auto get() -> metrics_t &;
+
+  auto counter(const std::string &name, const std::string &help, const metric_labels_t &labels = {}) -> metric_counter_t &;
+  auto gauge(const std::string &name, const std::string &help, const metric_labels_t &labels = {}) -> metric_gauge_t &;
+  // Buckets are only used by the first call for a given name and labels
+  auto histogram(const std::string &name, const std::string &help, const std::vector<double> &buckets, const metric_labels_t &labels = {}) -> metric_histogram_t &;
+
+  auto render_prometheus() const -> std::string;
+
+  // Bucket helpers
+  static auto exponential_buckets(double start, double factor, int count) -> std::vector<double>;
+  static auto seconds_buckets() -> std::vector<double>; // 0.1 ms .. ~3 s
+
+private:
+  enum class type_e
+  {
+    counter,
+    gauge,
+    histogram
+  };
+
+  struct family_t
+  {
+    type_e type;
+    std::string help;
+    // Rendered label set -> metric
+    std::map<std::string, std::unique_ptr<metric_counter_t>> counters;
+    std::map<std::string, std::unique_ptr<metric_gauge_t>> gauges;
+    std::map<std::string, std::unique_ptr<metric_histogram_t>> histograms;
+  };
+
+  auto get_family(const std::string &name, const std::string &help, type_e type) -> family_t &;
+
+  mutable std::mutex m_mutex;
+  std::map<std::string, family_t> m_families;
+};
+
+/**
+ * @brief Publishes metrics_t for soak runs: a localhost HTTP endpoint (GET /metrics) and/or a
+ * file rewritten every `interval_seconds`. Both run on background threads until stop().
+ */
+class metrics_exporter_t
+{
+public:
+  ~metrics_exporter_t();
+
+  // port 0 = no HTTP endpoint, empty path = no file dump. False if the endpoint couldn't be opened.
+  auto start(int port, const std::string &dump_path, double interval_seconds = 10.0) -> bool;
+  auto stop() -> void;
+
+private:
+  auto serve() -> void;
+  auto dump_loop() -> void;
+  auto write_dump() -> void;
+
+  std::atomic<bool> m_running{false};
+  int m_listen_fd = -1;
+  std::string m_dump_path;
+  double m_interval_seconds = 10.0;
+  std::mutex m_wake_mutex;
+  std::condition_variable m_wake;
+  std::thread m_http_thread;
+  std::thread m_dump_thread;
+};
+
+} // namespace deepbound
@@ -0,0 +1,34 @@
+#include "core/common/parallel_for.hpp"
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace deepbound
+{
+
+auto parallel_for(size_t count, const std::function<void(size_t)> &fn) -> void
+{
+  const size_t workers = std::min<size_t>(std::max(1u, std::min(std::thread::hardware_concurrency(), 8u)), count);
+  if (workers <= 1)
+  {
+    for (size_t i = 0; i < count; i++)
+      fn(i);
+    return;
+  }
+
+  std::vector<std::future<void>> jobs;
+  for (size_t w = 0; w < workers; w++)
+  {
+    jobs.push_back(std::async(std::launch::async,
+                              [&, w]()
+                              {
+                                for (size_t i = w; i < count; i += workers)
+                                  fn(i);
+                              }));
+  }
+  for (auto &job : jobs)
+    job.get();
+}
+
+} // namespace deepbound
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace deepbound
+{
+
+/**
+ * @brief Calls fn(i) for every i in [0, count) across up to 8 threads and waits for all of them.
+ *
+ * Indices are striped across workers (worker w takes w, w + workers, ...), so runs of large and
+ * small items spread evenly. fn must be safe to call concurrently for different indices.
+ */
+auto parallel_for(size_t count, const std::function<void(size_t)> &fn) -> void;
+
+} // namespace deepbound
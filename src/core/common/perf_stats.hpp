@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace deepbound
+{
+
+/**
+ * @brief Percentile summary of a set of timings (any unit, usually ms or ns).
+ */
+struct perf_summary_t
+{
+  size_t count = 0;
+  double mean = 0.0;
+  double p50 = 0.0;
+  double p90 = 0.0;
+  double p99 = 0.0;
+  double max = 0.0;
+};
+
+// Nearest-rank percentile of sorted samples, p in [0, 100]
+inline auto percentile_sorted(const std::vector<double> &sorted, double p) -> double
+{
+  if (sorted.empty())
+    return 0.0;
+  size_t rank = (size_t)std::ceil(p / 100.0 * (double)sorted.size());
+  return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+inline auto summarize(std::vector<double> samples) -> perf_summary_t
+{
+  perf_summary_t s;
+  if (samples.empty())
+    return s;
+
+  std::sort(samples.begin(), samples.end());
+  double total = 0.0;
+  for (double v : samples)
+    total += v;
+
+  s.count = samples.size();
+  s.mean = total / (double)samples.size();
+  s.p50 = percentile_sorted(samples, 50.0);
+  s.p90 = percentile_sorted(samples, 90.0);
+  s.p99 = percentile_sorted(samples, 99.0);
+  s.max = samples.back();
+  return s;
+}
+
+} // namespace deepbound
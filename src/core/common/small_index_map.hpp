@@ -0,0 +1,197 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace deepbound
+{
+
+/**
+ * @brief Hash map from a 16-bit index (e.g. a tile within a chunk) to V, with inline storage.
+ *
+ * Open addressing with linear probing. The first INLINE slots live inside the object, so a handful
+ * of entries never touch the heap; past 3/4 load the table moves to a heap array that doubles as
+ * it fills. Erase uses backward shifting, so there are no tombstones and lookups stay O(1).
+ * INLINE must be a power of two. V must be default constructible and movable.
+ */
+template <typename V, size_t INLINE = 8>
+class small_index_map_t
+{
+  static_assert(INLINE >= 2 && (INLINE & (INLINE - 1)) == 0, "INLINE must be a power of two");
+
+public:
+  static constexpr uint16_t EMPTY = 0xffff;
+
+  auto size() const -> size_t
+  {
+    return m_size;
+  }
+  auto empty() const -> bool
+  {
+    return m_size == 0;
+  }
+
+  auto find(uint16_t key) -> V *
+  {
+    size_t i = probe(key);
+    return slots()[i].key == key ? &slots()[i].value : nullptr;
+  }
+  auto find(uint16_t key) const -> const V *
+  {
+    size_t i = probe(key);
+    return slots()[i].key == key ? &slots()[i].value : nullptr;
+  }
+
+  // Default-constructs the value if the key is new
+  auto get_or_insert(uint16_t key) -> V &
+  {
+    size_t i = probe(key);
+    if (slots()[i].key == key)
+      return slots()[i].value;
+
+    if ((m_size + 1) * 4 > capacity() * 3)
+    {
+      grow();
+      i = probe(key);
+    }
+    slots()[i].key = key;
+    m_size++;
+    return slots()[i].value;
+  }
+
+  auto erase(uint16_t key) -> bool
+  {
+    slot_t *s = slots();
+    const size_t mask = capacity() - 1;
+    size_t i = probe(key);
+    if (s[i].key != key)
+      return false;
+
+    // Pull later entries of the probe chain back into the hole
+    size_t j = i;
+    while (true)
+    {
+      j = (j + 1) & mask;
+      if (s[j].key == EMPTY)
+        break;
+      size_t home = hash(s[j].key) & mask;
+      bool movable = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+      if (movable)
+      {
+        s[i] = std::move(s[j]);
+        i = j;
+      }
+    }
+    s[i].key = EMPTY;
+    s[i].value = V{};
+    m_size--;
+    return true;
+  }
+
+  auto clear() -> void
+  {
+    m_heap.clear();
+    m_heap.shrink_to_fit();
+    for (auto &s : m_inline)
+      s = slot_t{};
+    m_size = 0;
+  }
+
+  // f(uint16_t key, V &value), in slot order
+  template <typename F>
+  auto for_each(F &&f) -> void
+  {
+    slot_t *s = slots();
+    for (size_t i = 0; i < capacity(); i++)
+    {
+      if (s[i].key != EMPTY)
+        f(s[i].key, s[i].value);
+    }
+  }
+  template <typename F>
+  auto for_each(F &&f) const -> void
+  {
+    const slot_t *s = slots();
+    for (size_t i = 0; i < capacity(); i++)
+    {
+      if (s[i].key != EMPTY)
+        f(s[i].key, s[i].value);
+    }
+  }
+
+private:
+  struct slot_t
+  {
+    uint16_t key = EMPTY;
+    V value{};
+  };
+
+  static auto hash(uint16_t key) -> size_t
+  {
+    // Neighbouring tiles shouldn't share a probe chain
+    return (size_t)((key * 40503u) >> 4);
+  }
+
+  auto capacity() const -> size_t
+  {
+    return m_heap.empty() ? INLINE : m_heap.size();
+  }
+  auto slots() -> slot_t *
+  {
+    return m_heap.empty() ? m_inline.data() : m_heap.data();
+  }
+  auto slots() const -> const slot_t *
+  {
+    return m_heap.empty() ? m_inline.data() : m_heap.data();
+  }
+
+  // Slot holding `key`, or the empty slot where it would go
+  auto probe(uint16_t key) const -> size_t
+  {
+    const slot_t *s = slots();
+    const size_t mask = capacity() - 1;
+    size_t i = hash(key) & mask;
+    while (s[i].key != EMPTY && s[i].key != key)
+      i = (i + 1) & mask;
+    return i;
+  }
+
+  auto grow() -> void
+  {
+    std::vector<slot_t> old;
+    if (m_heap.empty())
+    {
+      old.reserve(INLINE);
+      for (auto &s : m_inline)
+      {
+        old.push_back(std::move(s));
+        s = slot_t{};
+      }
+    }
+    else
+    {
+      old = std::move(m_heap);
+    }
+
+    m_heap = std::vector<slot_t>(old.size() * 2);
+    const size_t mask = m_heap.size() - 1;
+    for (auto &s : old)
+    {
+      if (s.key == EMPTY)
+        continue;
+      size_t i = hash(s.key) & mask;
+      while (m_heap[i].key != EMPTY)
+        i = (i + 1) & mask;
+      m_heap[i] = std::move(s);
+    }
+  }
+
+  std::array<slot_t, INLINE> m_inline;
+  std::vector<slot_t> m_heap; // Empty while the inline slots are in use
+  size_t m_size = 0;
+};
+
+} // namespace deepbound
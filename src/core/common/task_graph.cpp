@@ -0,0 +1,221 @@
+#include "core/common/task_graph.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+namespace deepbound
+{
+
+auto task_graph_t::add(const std::string &name, std::function<void()> fn, std::vector<std::string> dependencies, affinity_e affinity) -> void
+{
+  task_t task;
+  task.name = name;
+  task.fn = std::move(fn);
+  task.dependencies = std::move(dependencies);
+  task.affinity = affinity;
+  m_tasks.push_back(std::move(task));
+}
+
+auto task_graph_t::resolve() -> bool
+{
+  std::unordered_map<std::string, size_t> index;
+  for (size_t i = 0; i < m_tasks.size(); i++)
+  {
+    if (!index.emplace(m_tasks[i].name, i).second)
+    {
+      std::cerr << "Task graph: duplicate task '" << m_tasks[i].name << "'" << std::endl;
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i < m_tasks.size(); i++)
+  {
+    m_tasks[i].dependents.clear();
+    m_tasks[i].remaining = 0;
+  }
+  for (size_t i = 0; i < m_tasks.size(); i++)
+  {
+    for (const auto &dep : m_tasks[i].dependencies)
+    {
+      auto it = index.find(dep);
+      if (it == index.end())
+      {
+        std::cerr << "Task graph: '" << m_tasks[i].name << "' depends on unknown task '" << dep << "'" << std::endl;
+        return false;
+      }
+      m_tasks[it->second].dependents.push_back(i);
+      m_tasks[i].remaining++;
+    }
+  }
+
+  // Every task must be reachable in topological order, otherwise there's a cycle
+  std::vector<int> remaining;
+  std::vector<size_t> order;
+  for (const auto &task : m_tasks)
+    remaining.push_back(task.remaining);
+  for (size_t i = 0; i < m_tasks.size(); i++)
+  {
+    if (remaining[i] == 0)
+      order.push_back(i);
+  }
+  for (size_t n = 0; n < order.size(); n++)
+  {
+    for (size_t d : m_tasks[order[n]].dependents)
+    {
+      if (--remaining[d] == 0)
+        order.push_back(d);
+    }
+  }
+  if (order.size() != m_tasks.size())
+  {
+    std::cerr << "Task graph: dependency cycle between";
+    for (size_t i = 0; i < m_tasks.size(); i++)
+    {
+      if (remaining[i] > 0)
+        std::cerr << " '" << m_tasks[i].name << "'";
+    }
+    std::cerr << std::endl;
+    return false;
+  }
+  return true;
+}
+
+auto task_graph_t::run() -> bool
+{
+  if (!resolve())
+    return false;
+
+  using clock = std::chrono::steady_clock;
+  const auto origin = clock::now();
+  auto now_ms = [&]() { return std::chrono::duration<double, std::milli>(clock::now() - origin).count(); };
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<size_t> main_queue;
+  std::vector<std::future<void>> workers;
+  int running = 0; // Started worker tasks plus queued main thread tasks
+  size_t finished = 0;
+  bool failed = false;
+
+  // Called with the lock held
+  std::function<void(size_t)> finish;
+  std::function<void(size_t)> schedule = [&](size_t i)
+  {
+    task_t &task = m_tasks[i];
+    task.started = true;
+    running++;
+    if (task.affinity == affinity_e::main_thread)
+    {
+      main_queue.push_back(i);
+      cv.notify_all();
+      return;
+    }
+    workers.push_back(std::async(std::launch::async,
+                                 [&, i]()
+                                 {
+                                   m_tasks[i].start_ms = now_ms();
+                                   bool ok = true;
+                                   try
+                                   {
+                                     m_tasks[i].fn();
+                                   }
+                                   catch (const std::exception &e)
+                                   {
+                                     ok = false;
+                                     std::cerr << "Task '" << m_tasks[i].name << "' failed: " << e.what() << std::endl;
+                                   }
+                                   std::lock_guard<std::mutex> lock(mutex);
+                                   m_tasks[i].end_ms = now_ms();
+                                   failed = failed || !ok;
+                                   finish(i);
+                                 }));
+  };
+  finish = [&](size_t i)
+  {
+    running--;
+    finished++;
+    if (!failed)
+    {
+      for (size_t d : m_tasks[i].dependents)
+      {
+        if (--m_tasks[d].remaining == 0)
+          schedule(d);
+      }
+    }
+    cv.notify_all();
+  };
+
+  std::unique_lock<std::mutex> lock(mutex);
+  for (size_t i = 0; i < m_tasks.size(); i++)
+  {
+    if (m_tasks[i].remaining == 0)
+      schedule(i);
+  }
+
+  while (true)
+  {
+    cv.wait(lock, [&]() { return !main_queue.empty() || running == 0; });
+    if (main_queue.empty())
+      break;
+
+    size_t i = main_queue.front();
+    main_queue.pop_front();
+    if (failed)
+    {
+      running--;
+      continue;
+    }
+
+    lock.unlock();
+    m_tasks[i].start_ms = now_ms();
+    bool ok = true;
+    try
+    {
+      m_tasks[i].fn();
+    }
+    catch (const std::exception &e)
+    {
+      ok = false;
+      std::cerr << "Task '" << m_tasks[i].name << "' failed: " << e.what() << std::endl;
+    }
+    lock.lock();
+    m_tasks[i].end_ms = now_ms();
+    failed = failed || !ok;
+    finish(i);
+  }
+
+  // Every worker has reported back by now; this only joins their threads
+  auto done = std::move(workers);
+  lock.unlock();
+  for (auto &f : done)
+    f.get();
+
+  m_total_ms = now_ms();
+  return !failed && finished == m_tasks.size();
+}
+
+auto task_graph_t::print_timings(std::ostream &out) const -> void
+{
+  std::vector<const task_t *> started;
+  for (const auto &task : m_tasks)
+  {
+    if (task.started)
+      started.push_back(&task);
+  }
+  std::sort(started.begin(), started.end(), [](const task_t *a, const task_t *b) { return a->start_ms < b->start_ms; });
+
+  for (const auto *task : started)
+  {
+    out << "  " << std::left << std::setw(20) << task->name << std::right << (task->affinity == affinity_e::main_thread ? " main  " : " worker") << std::fixed
+        << std::setprecision(1) << std::setw(9) << task->start_ms << " ms +" << std::setw(8) << task->end_ms - task->start_ms << " ms" << std::endl;
+  }
+  out << "  total " << std::fixed << std::setprecision(1) << m_total_ms << " ms" << std::endl;
+}
+
+} // namespace deepbound
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace deepbound
+{
+
+/**
+ * @brief A one-shot dependency graph of named tasks, used to overlap startup work.
+ *
+ * Worker tasks run on their own threads as soon as their dependencies finish. Main thread tasks
+ * (window, GL, ImGui) run on the thread that calls run(), in between waiting for workers. A task
+ * that throws stops anything not yet started; run() then reports it and returns false.
+ */
+class task_graph_t
+{
+public:
+  enum class affinity_e
+  {
+    worker,
+    main_thread
+  };
+
+  auto add(const std::string &name, std::function<void()> fn, std::vector<std::string> dependencies = {}, affinity_e affinity = affinity_e::worker) -> void;
+
+  auto run() -> bool;
+
+  // Start and duration of each task relative to run(), in start order
+  auto print_timings(std::ostream &out) const -> void;
+
+private:
+  struct task_t
+  {
+    std::string name;
+    std::function<void()> fn;
+    std::vector<std::string> dependencies;
+    affinity_e affinity;
+
+    std::vector<size_t> dependents;
+    int remaining = 0;
+    bool started = false;
+    double start_ms = 0.0;
+    double end_ms = 0.0;
+  };
+
+  auto resolve() -> bool;
+
+  std::vector<task_t> m_tasks;
+  double m_total_ms = 0.0;
+};
+
+} // namespace deepbound
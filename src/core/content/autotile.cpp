@@ -0,0 +1,136 @@
+#include "core/content/autotile.hpp"
+#include <algorithm>
+
+namespace deepbound
+{
+
+namespace
+{
+constexpr int N = (int)autotile_dir_e::north;
+constexpr int E = (int)autotile_dir_e::east;
+constexpr int S = (int)autotile_dir_e::south;
+constexpr int W = (int)autotile_dir_e::west;
+constexpr int NE = (int)autotile_dir_e::north_east;
+constexpr int SE = (int)autotile_dir_e::south_east;
+constexpr int SW = (int)autotile_dir_e::south_west;
+constexpr int NW = (int)autotile_dir_e::north_west;
+
+// Membership bits of one group: bit hx of bits[hy] = halo tile (hx, hy) is in the group
+using group_rows_t = std::array<uint64_t, autotile_masks_t::HALO>;
+
+auto reduce_corners(int mask) -> int
+{
+  auto has = [&](int d) { return (mask >> d) & 1; };
+  int out = mask & 0x0f;
+  if (has(N) && has(E) && has(NE))
+    out |= 1 << NE;
+  if (has(S) && has(E) && has(SE))
+    out |= 1 << SE;
+  if (has(S) && has(W) && has(SW))
+    out |= 1 << SW;
+  if (has(N) && has(W) && has(NW))
+    out |= 1 << NW;
+  return out;
+}
+
+// 256 masks -> 47 variants, numbered in order of their reduced mask
+auto blob_table() -> const std::array<uint8_t, 256> &
+{
+  static const std::array<uint8_t, 256> table = []()
+  {
+    std::array<int, 256> index;
+    index.fill(-1);
+    int next = 0;
+    for (int m = 0; m < 256; m++)
+    {
+      if (reduce_corners(m) == m)
+        index[m] = next++;
+    }
+
+    std::array<uint8_t, 256> t = {};
+    for (int m = 0; m < 256; m++)
+      t[m] = (uint8_t)index[reduce_corners(m)];
+    return t;
+  }();
+  return table;
+}
+} // namespace
+
+auto autotile_masks_t::build(const uint8_t *groups, int y_begin, int y_end) -> void
+{
+  y_begin = std::max(y_begin, 0);
+  y_end = std::min(y_end, SIZE);
+  if (y_begin >= y_end)
+    return;
+
+  // Gather per-group row words for the halo rows we read
+  std::array<group_rows_t, 16> local;
+  std::array<uint8_t, 256> slot_of;
+  slot_of.fill(0xff);
+  int slot_count = 0;
+
+  for (int hy = y_begin; hy <= y_end + 1; hy++)
+  {
+    const uint8_t *row = groups + hy * HALO;
+    for (int hx = 0; hx < HALO; hx++)
+    {
+      uint8_t g = row[hx];
+      if (g == 0)
+        continue;
+
+      if (slot_of[g] == 0xff)
+      {
+        if (slot_count == (int)local.size())
+          continue; // More groups meeting in one chunk than we track; the rest stay unconnected
+        slot_of[g] = (uint8_t)slot_count;
+        local[slot_count].fill(0);
+        slot_count++;
+      }
+      local[slot_of[g]][hy] |= 1ull << hx;
+    }
+  }
+
+  for (int d = 0; d < (int)autotile_dir_e::count; d++)
+    std::fill(rows[d].begin() + y_begin, rows[d].begin() + y_end, 0u);
+
+  // Tile x sits at bit x + 1 of its halo row, so >> 1 lines a row up with the tiles, >> 2 brings
+  // in the east neighbour and >> 0 the west one
+  for (int s = 0; s < slot_count; s++)
+  {
+    const auto &b = local[s];
+    for (int y = y_begin; y < y_end; y++)
+    {
+      const int hy = y + 1;
+      const uint64_t own = (b[hy] >> 1) & 0xffffffffull;
+      if (!own)
+        continue;
+
+      const uint64_t up = b[hy + 1];
+      const uint64_t mid = b[hy];
+      const uint64_t down = b[hy - 1];
+
+      rows[N][y] |= (uint32_t)(own & (up >> 1));
+      rows[E][y] |= (uint32_t)(own & (mid >> 2));
+      rows[S][y] |= (uint32_t)(own & (down >> 1));
+      rows[W][y] |= (uint32_t)(own & mid);
+      rows[NE][y] |= (uint32_t)(own & (up >> 2));
+      rows[SE][y] |= (uint32_t)(own & (down >> 2));
+      rows[SW][y] |= (uint32_t)(own & down);
+      rows[NW][y] |= (uint32_t)(own & up);
+    }
+  }
+}
+
+auto autotile_variant_count(int connectivity) -> int
+{
+  return connectivity == 8 ? 47 : 16;
+}
+
+auto autotile_variant(uint8_t mask, int connectivity) -> int
+{
+  if (connectivity == 8)
+    return blob_table()[mask];
+  return mask & 0x0f;
+}
+
+} // namespace deepbound
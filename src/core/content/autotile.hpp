@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace deepbound
+{
+
+enum class autotile_dir_e : int
+{
+  north,
+  east,
+  south,
+  west,
+  north_east,
+  south_east,
+  south_west,
+  north_west,
+  count
+};
+
+/**
+ * @brief Autotile connectivity for one chunk, stored as row bitsets.
+ *
+ * rows[dir][y] has bit x set when tile (x, y) and its neighbour in `dir` share an autotile group.
+ * build() works from the group ids of the chunk plus a one-tile halo: each group present gets one
+ * 64-bit word per halo row, and every direction is then a shift and an AND of those words, so a
+ * whole row costs a handful of bit operations per group. Edits only need their rows rebuilt.
+ */
+struct autotile_masks_t
+{
+  static constexpr int SIZE = 32; // Matches chunk_t::SIZE
+  static constexpr int HALO = SIZE + 2;
+
+  std::array<std::array<uint32_t, SIZE>, (int)autotile_dir_e::count> rows = {};
+
+  // Bit d set = connected in autotile_dir_e d
+  auto get_mask(int x, int y) const -> uint8_t
+  {
+    uint8_t mask = 0;
+    for (int d = 0; d < (int)autotile_dir_e::count; d++)
+      mask |= (uint8_t)(((rows[d][y] >> x) & 1u) << d);
+    return mask;
+  }
+
+  // Rebuilds rows [y_begin, y_end). groups[(x + 1) + (y + 1) * HALO] is the group id of local tile
+  // (x, y), halo included; 0 = not autotiled. Only halo rows y_begin - 1 .. y_end are read.
+  auto build(const uint8_t *groups, int y_begin = 0, int y_end = SIZE) -> void;
+};
+
+// Number of atlas variants per tile: 16 for 4-neighbour tiles, 47 for 8-neighbour tiles
+auto autotile_variant_count(int connectivity) -> int;
+
+// Atlas variant index for a mask. With 8 neighbours a corner only counts when both edges next to
+// it connect, which folds the 256 masks down to the usual 47.
+auto autotile_variant(uint8_t mask, int connectivity) -> int;
+
+} // namespace deepbound
@@ -34,6 +34,14 @@ struct item_definition_t {
   std::map<std::string, std::string> attributes;
 };
 
+/**
+ * @brief A number of one item, e.g. a container slot. Empty when item is null.
+ */
+struct item_stack_t {
+  const item_definition_t *item = nullptr;
+  int count = 0;
+};
+
 /**
  * @brief Registry for all item definitions.
  */
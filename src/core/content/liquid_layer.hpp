@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace deepbound
+{
+
+struct liquid_cell_t
+{
+  uint16_t type = 0; // Runtime id of the liquid's tile definition, 0 = no liquid
+  uint8_t level = 0; // 1..255 (full) while type is set
+
+  auto empty() const -> bool
+  {
+    return type == 0 || level == 0;
+  }
+};
+
+/**
+ * @brief Liquids of one chunk, stored apart from the tiles so they can share a cell with one.
+ *
+ * The chunk is split into SECTION x SECTION sections; only sections holding liquid are allocated and
+ * a bit mask says which, so dry chunks cost one empty check and renderers and the simulation visit
+ * liquid-bearing sections only. Coordinates are chunk-local tiles.
+ *
+ * The awake mask is for the simulation: sections where something changed and liquid may still flow.
+ */
+class liquid_layer_t
+{
+public:
+  static constexpr int SIZE = 32; // Must match chunk_t::SIZE
+  static constexpr int SECTION = 8;
+  static constexpr int SECTIONS_PER_EDGE = SIZE / SECTION;
+
+  auto empty() const -> bool
+  {
+    return m_mask == 0;
+  }
+
+  auto get(int x, int y) const -> liquid_cell_t
+  {
+    if (x < 0 || x >= SIZE || y < 0 || y >= SIZE)
+      return {};
+    const auto &section = m_sections[section_index(x, y)];
+    return section ? section->cells[cell_index(x, y)] : liquid_cell_t{};
+  }
+
+  // An empty cell clears it; a section is freed with its last liquid cell
+  auto set(int x, int y, liquid_cell_t cell) -> void
+  {
+    if (x < 0 || x >= SIZE || y < 0 || y >= SIZE)
+      return;
+    if (cell.empty())
+      cell = {};
+
+    const int s = section_index(x, y);
+    auto &section = m_sections[s];
+    if (!section)
+    {
+      if (cell.empty())
+        return;
+      section = std::make_unique<section_t>();
+      m_mask |= (uint16_t)(1u << s);
+    }
+
+    auto &slot = section->cells[cell_index(x, y)];
+    section->count += (slot.empty() ? 0 : -1) + (cell.empty() ? 0 : 1);
+    slot = cell;
+    if (section->count == 0)
+    {
+      section.reset();
+      m_mask &= (uint16_t) ~(1u << s);
+    }
+  }
+
+  // Bit (sy * SECTIONS_PER_EDGE + sx) per section holding liquid
+  auto get_mask() const -> uint16_t
+  {
+    return m_mask;
+  }
+
+  // f(x, y, cell) for every liquid cell, visiting allocated sections only
+  template <typename F>
+  auto for_each(F &&f) const -> void
+  {
+    for (int s = 0; s < SECTIONS_PER_EDGE * SECTIONS_PER_EDGE; s++)
+    {
+      if (!(m_mask & (1u << s)))
+        continue;
+      const int x0 = (s % SECTIONS_PER_EDGE) * SECTION;
+      const int y0 = (s / SECTIONS_PER_EDGE) * SECTION;
+      for (int x = x0; x < x0 + SECTION; x++)
+      {
+        for (int y = y0; y < y0 + SECTION; y++)
+        {
+          const liquid_cell_t &cell = m_sections[s]->cells[cell_index(x, y)];
+          if (!cell.empty())
+            f(x, y, cell);
+        }
+      }
+    }
+  }
+
+  auto wake(int x, int y) -> void
+  {
+    if (x >= 0 && x < SIZE && y >= 0 && y < SIZE)
+      m_awake |= (uint16_t)(1u << section_index(x, y));
+  }
+  // Sections woken since the last call
+  auto take_awake() -> uint16_t
+  {
+    uint16_t awake = m_awake;
+    m_awake = 0;
+    return awake;
+  }
+  auto is_awake() const -> bool
+  {
+    return m_awake != 0;
+  }
+
+  auto memory_bytes() const -> size_t
+  {
+    size_t sections = 0;
+    for (uint16_t m = m_mask; m; m &= (uint16_t)(m - 1))
+      sections++;
+    return sections * sizeof(section_t);
+  }
+
+  static auto section_index(int x, int y) -> int
+  {
+    return (y / SECTION) * SECTIONS_PER_EDGE + x / SECTION;
+  }
+
+private:
+  struct section_t
+  {
+    std::array<liquid_cell_t, SECTION * SECTION> cells = {};
+    int count = 0; // Non-empty cells
+  };
+
+  static auto cell_index(int x, int y) -> int
+  {
+    return (x % SECTION) * SECTION + (y % SECTION);
+  }
+
+  std::array<std::unique_ptr<section_t>, SECTIONS_PER_EDGE * SECTIONS_PER_EDGE> m_sections;
+  uint16_t m_mask = 0;
+  uint16_t m_awake = 0;
+};
+
+} // namespace deepbound
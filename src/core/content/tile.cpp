@@ -1,4 +1,5 @@
 #include "core/content/tile.hpp"
+#include <iostream>
 
 namespace deepbound {
 
@@ -9,7 +10,15 @@ auto tile_registry_t::get() -> tile_registry_t & {
 
 auto tile_registry_t::register_tile(const tile_definition_t &definition)
     -> void {
-  m_tile_map[definition.id] = definition;
+  // Registering an id again replaces the definition but keeps its runtime id
+  auto &tile = m_tile_map[definition.id];
+  uint16_t runtime_id = tile.runtime_id ? tile.runtime_id : m_next_runtime_id++;
+  tile = definition;
+  tile.runtime_id = runtime_id;
+  if (m_by_runtime_id.size() <= runtime_id) {
+    m_by_runtime_id.resize(runtime_id + 1, nullptr);
+  }
+  m_by_runtime_id[runtime_id] = &tile;
 }
 
 auto tile_registry_t::get_tile(const resource_id_t &id) const
@@ -26,4 +35,20 @@ auto tile_registry_t::get_all_tiles() const
   return m_tile_map;
 }
 
+auto tile_registry_t::get_autotile_group(const std::string &name)
+    -> uint8_t {
+  auto it = m_autotile_groups.find(name);
+  if (it != m_autotile_groups.end()) {
+    return it->second;
+  }
+  if (m_autotile_groups.size() >= 255) {
+    std::cerr << "Warning: Too many autotile groups, '" << name
+              << "' will not connect" << std::endl;
+    return 0;
+  }
+  uint8_t id = (uint8_t)(m_autotile_groups.size() + 1);
+  m_autotile_groups[name] = id;
+  return id;
+}
+
 } // namespace deepbound
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/common/resource_id.hpp"
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -32,6 +33,7 @@ struct collision_box_t
 struct tile_definition_t
 {
   resource_id_t id;       // The internal numeric/hashed ID or full string resource ID
+  uint16_t runtime_id = 0; // Dense, assigned on registration (from 1), indexes per-tile tables. Not stable across runs.
   std::string code;       // e.g. "soil" - the definition name
   std::string class_name; // e.g. "BlockSoil" - C++ class mapping
 
@@ -51,6 +53,11 @@ struct tile_definition_t
   // Simple key-value attributes for now, ideally this is a JSON object
   std::map<std::string, std::string> attributes;
 
+  // Autotiling (see autotile.hpp): tiles sharing a group connect to each other, 0 = off
+  uint8_t autotile_group = 0;
+  int autotile_connectivity = 4;                  // 4 or 8 neighbours
+  std::vector<resource_id_t> autotile_variants; // Indexed by autotile_variant(), empty path = base texture
+
   bool is_solid = true;
   float hardness = 1.0f;
   collision_box_t collision_box;
@@ -70,10 +77,26 @@ public:
   auto register_tile(const tile_definition_t &definition) -> void;
   auto get_tile(const resource_id_t &id) const -> const tile_definition_t *;
   auto get_all_tiles() const -> const std::map<resource_id_t, tile_definition_t> &;
+  // Runtime ids are below this
+  auto get_runtime_id_count() const -> size_t
+  {
+    return m_next_runtime_id;
+  }
+  // Null for 0 and unknown ids
+  auto get_tile_by_runtime_id(uint16_t runtime_id) const -> const tile_definition_t *
+  {
+    return runtime_id < m_by_runtime_id.size() ? m_by_runtime_id[runtime_id] : nullptr;
+  }
+
+  // Small id for an autotile group name, assigned on first use. 0 if all 255 are taken.
+  auto get_autotile_group(const std::string &name) -> uint8_t;
 
 private:
   tile_registry_t() = default;
   std::map<resource_id_t, tile_definition_t> m_tile_map;
+  std::map<std::string, uint8_t> m_autotile_groups;
+  uint16_t m_next_runtime_id = 1; // 0 = air (null tile)
+  std::vector<const tile_definition_t *> m_by_runtime_id;
 };
 
 } // namespace deepbound
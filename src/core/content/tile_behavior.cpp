@@ -0,0 +1,81 @@
+#include "core/content/tile_behavior.hpp"
+#include "core/content/tile.hpp"
+#include "core/worldgen/world.hpp"
+#include <iostream>
+#include <set>
+
+namespace deepbound
+{
+
+namespace
+{
+// Sand, gravel: drops into air below. Moving edits both tiles, which notifies the tile above, so a
+// column comes down one tile per update from the bottom up.
+void unstable_falling(world_t &world, int x, int y, const tile_definition_t &tile)
+{
+  // Not into unloaded chunks, the tile would be lost
+  if (world.get_tile_at(x, y - 1) != nullptr || !world.is_tile_loaded(x, y - 1))
+    return;
+  // Leave first, so liquid below can swap into the freed cell
+  world.set_tile_at(x, y, nullptr);
+  if (!world.set_tile_at(x, y - 1, &tile))
+    world.set_tile_at(x, y, &tile);
+}
+} // namespace
+
+tile_behavior_registry_t::tile_behavior_registry_t()
+{
+  register_behavior({"UnstableFalling", nullptr, &unstable_falling});
+}
+
+auto tile_behavior_registry_t::get() -> tile_behavior_registry_t &
+{
+  static tile_behavior_registry_t instance;
+  return instance;
+}
+
+auto tile_behavior_registry_t::register_behavior(const tile_behavior_t &behavior) -> void
+{
+  m_behaviors[behavior.name] = behavior;
+}
+
+auto tile_behavior_registry_t::compile() -> void
+{
+  const auto &tiles = tile_registry_t::get();
+  m_flags.assign(tiles.get_runtime_id_count(), 0);
+  m_dispatch.assign(tiles.get_runtime_id_count(), {});
+
+  std::set<std::string> unknown;
+  for (const auto &[id, tile] : tiles.get_all_tiles())
+  {
+    dispatch_t &dispatch = m_dispatch[tile.runtime_id];
+    for (const auto &name : tile.behaviors)
+    {
+      auto it = m_behaviors.find(name);
+      if (it == m_behaviors.end())
+      {
+        if (unknown.insert(name).second)
+          std::cerr << "Warning: Unknown tile behavior '" << name << "' (first used by " << tile.code << ")" << std::endl;
+        continue;
+      }
+      if (it->second.on_tick)
+        dispatch.on_tick.push_back(it->second.on_tick);
+      if (it->second.on_neighbour_changed)
+        dispatch.on_neighbour_changed.push_back(it->second.on_neighbour_changed);
+    }
+    dispatch.flags = (dispatch.on_tick.empty() ? 0 : tile_behavior_flags::ticks) | (dispatch.on_neighbour_changed.empty() ? 0 : tile_behavior_flags::neighbour_changed);
+    m_flags[tile.runtime_id] = dispatch.flags;
+  }
+}
+
+auto tile_behavior_registry_t::get_flags(const tile_definition_t *tile) const -> uint8_t
+{
+  return (tile && tile->runtime_id < m_flags.size()) ? m_flags[tile->runtime_id] : 0;
+}
+
+auto tile_behavior_registry_t::get_dispatch(const tile_definition_t &tile) const -> const dispatch_t &
+{
+  return tile.runtime_id < m_dispatch.size() ? m_dispatch[tile.runtime_id] : m_empty;
+}
+
+} // namespace deepbound
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace deepbound
+{
+
+struct tile_definition_t;
+class world_t;
+
+// What a tile's behaviours respond to, one bit per handler kind
+namespace tile_behavior_flags
+{
+constexpr uint8_t ticks = 1 << 0;             // Called at the world tick rate while loaded
+constexpr uint8_t neighbour_changed = 1 << 1; // Called when it or one of its 8 neighbours was edited
+} // namespace tile_behavior_flags
+
+/**
+ * @brief A named piece of tile logic. Tiles list behaviour names in JSON ("behaviors"); handlers
+ * left null don't take part in that event.
+ */
+struct tile_behavior_t
+{
+  using tick_fn = void (*)(world_t &world, int x, int y, const tile_definition_t &tile);
+  using neighbour_changed_fn = void (*)(world_t &world, int x, int y, const tile_definition_t &tile);
+
+  std::string name;
+  tick_fn on_tick = nullptr;
+  neighbour_changed_fn on_neighbour_changed = nullptr;
+};
+
+/**
+ * @brief Behaviour registry, compiled into flat dispatch tables indexed by tile runtime id.
+ *
+ * Names are resolved once in compile(), after tiles are loaded: each tile gets its handler lists
+ * and a flags byte, so systems can skip tiles without a relevant handler with one array lookup and
+ * never compare strings at run time. Register behaviours before compiling; compile again if tiles
+ * or behaviours change.
+ */
+class tile_behavior_registry_t
+{
+public:
+  struct dispatch_t
+  {
+    uint8_t flags = 0;
+    std::vector<tile_behavior_t::tick_fn> on_tick;
+    std::vector<tile_behavior_t::neighbour_changed_fn> on_neighbour_changed;
+  };
+
+  static auto get() -> tile_behavior_registry_t &;
+
+  tile_behavior_registry_t(const tile_behavior_registry_t &) = delete;
+  auto operator=(const tile_behavior_registry_t &) -> tile_behavior_registry_t & = delete;
+
+  auto register_behavior(const tile_behavior_t &behavior) -> void;
+
+  // Builds the tables from every registered tile. Warns once per unknown behaviour name.
+  auto compile() -> void;
+
+  // Null tile (air) and tiles registered after compile() have no flags and no handlers
+  auto get_flags(const tile_definition_t *tile) const -> uint8_t;
+  auto get_dispatch(const tile_definition_t &tile) const -> const dispatch_t &;
+
+private:
+  tile_behavior_registry_t();
+
+  std::map<std::string, tile_behavior_t> m_behaviors;
+  std::vector<uint8_t> m_flags;       // By runtime id, kept apart so flag checks stay dense
+  std::vector<dispatch_t> m_dispatch; // By runtime id
+  dispatch_t m_empty;
+};
+
+} // namespace deepbound
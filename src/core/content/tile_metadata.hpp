@@ -0,0 +1,63 @@
+#pragma once
+
+#include "core/common/small_index_map.hpp"
+#include "core/content/item.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace deepbound
+{
+
+/**
+ * @brief Small per-tile state that doesn't fit in a tile pointer. All zero = nothing stored.
+ */
+struct tile_state_t
+{
+  uint8_t damage = 0;       // Mining progress, 0..255
+  uint8_t growth_stage = 0; // Crops, saplings, ...
+  uint8_t flags = 0;        // Tile-specific bits
+
+  auto is_default() const -> bool
+  {
+    return damage == 0 && growth_stage == 0 && flags == 0;
+  }
+};
+
+/**
+ * @brief Base for larger per-tile data (containers, machines, signs, ...).
+ */
+class block_entity_t
+{
+public:
+  virtual ~block_entity_t() = default;
+};
+
+class container_entity_t : public block_entity_t
+{
+public:
+  explicit container_entity_t(int slot_count = 0) : slots(slot_count)
+  {
+  }
+
+  std::vector<item_stack_t> slots;
+};
+
+/**
+ * @brief Sparse metadata for one chunk, keyed by local tile index (x * SIZE + y, as chunk_t::tiles).
+ *
+ * Only allocated once a tile in the chunk needs it; chunks without metadata hold a null pointer.
+ * A few entries fit inline, both maps grow on the heap beyond that.
+ */
+struct chunk_metadata_t
+{
+  small_index_map_t<tile_state_t, 16> states;
+  small_index_map_t<std::unique_ptr<block_entity_t>, 4> entities;
+
+  auto empty() const -> bool
+  {
+    return states.empty() && entities.empty();
+  }
+};
+
+} // namespace deepbound
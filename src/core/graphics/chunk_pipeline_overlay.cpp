@@ -0,0 +1,181 @@
+#include "core/graphics/chunk_pipeline_overlay.hpp"
+#include "core/graphics/chunk_renderer.hpp"
+#include "core/worldgen/floor_div.hpp"
+#include "core/worldgen/world.hpp"
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <unordered_set>
+#include "imgui.h"
+
+namespace deepbound
+{
+
+namespace
+{
+enum class pipeline_state_e
+{
+  none,
+  requested,
+  generating,
+  generated, // Loaded, mesh not built yet (or out of date)
+  meshed,    // Mesh built, GPU copy missing or older
+  uploaded,  // Current on the GPU and drawn this frame
+  cold,      // Current on the GPU, not drawn this frame
+  evicted,   // Was uploaded, dropped by the VRAM budget
+  count
+};
+
+struct state_style_t
+{
+  const char *name;
+  ImU32 color;
+};
+
+const std::array<state_style_t, (int)pipeline_state_e::count> styles = {{
+    {"none", IM_COL32(60, 60, 60, 120)},
+    {"requested", IM_COL32(200, 200, 60, 255)},
+    {"generating", IM_COL32(230, 140, 30, 255)},
+    {"generated", IM_COL32(60, 110, 220, 255)},
+    {"meshed", IM_COL32(60, 200, 220, 255)},
+    {"uploaded", IM_COL32(60, 200, 80, 255)},
+    {"cold", IM_COL32(30, 100, 40, 255)},
+    {"evicted", IM_COL32(220, 50, 50, 255)},
+}};
+
+auto classify(const world_t &world, const gpu_residency_t &residency, gpu_residency_t::kind_e kind, int cx, int cy) -> pipeline_state_e
+{
+  switch (world.get_chunk_load_state(cx, cy))
+  {
+  case world_t::chunk_load_state_e::none:
+    return pipeline_state_e::none;
+  case world_t::chunk_load_state_e::requested:
+    return pipeline_state_e::requested;
+  case world_t::chunk_load_state_e::generating:
+    return pipeline_state_e::generating;
+  case world_t::chunk_load_state_e::loaded:
+    break;
+  }
+
+  const chunk_t *chunk = world.find_loaded_chunk(cx, cy);
+  if (chunk->is_mesh_dirty())
+    return pipeline_state_e::generated;
+  if (chunk->get_mesh().empty())
+    return pipeline_state_e::meshed; // Nothing to draw, never goes to the GPU
+
+  uint64_t idle = 0;
+  const auto *gpu = residency.peek(kind, cx, cy, &idle);
+  if (gpu && gpu->version == chunk->mesh_version)
+    return idle == 0 ? pipeline_state_e::uploaded : pipeline_state_e::cold;
+  if (!gpu && chunk->pipeline.uploaded_version != 0)
+    return pipeline_state_e::evicted;
+  return pipeline_state_e::meshed;
+}
+
+auto draw_details(const world_t &world, const gpu_residency_t &residency, gpu_residency_t::kind_e kind, int cx, int cy, pipeline_state_e state) -> void
+{
+  ImGui::BeginTooltip();
+  ImGui::Text("Chunk %d, %d: %s", cx, cy, styles[(int)state].name);
+
+  const chunk_t *chunk = world.find_loaded_chunk(cx, cy);
+  if (chunk)
+  {
+    std::unordered_set<const tile_definition_t *> palette(chunk->tiles.begin(), chunk->tiles.end());
+    size_t cpu_bytes = chunk->tiles.capacity() * sizeof(chunk->tiles[0]) + chunk->climate.capacity() * sizeof(chunk->climate[0]) +
+                       chunk->get_mesh().capacity() * sizeof(float) + (chunk->metadata ? sizeof(chunk_metadata_t) : 0) +
+                       chunk->liquids.memory_bytes();
+    double seen_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - chunk->pipeline.last_visible).count();
+
+    ImGui::Text("Generate: %.2f ms  wait: %.2f ms", chunk->pipeline.generate_ms, chunk->pipeline.wait_ms);
+    ImGui::Text("CPU: %.1f KB  palette: %zu", cpu_bytes / 1024.0, palette.size());
+    ImGui::Text("Mesh: %zu vertices%s", chunk->get_mesh().size() / 7, chunk->is_mesh_dirty() ? " (dirty)" : "");
+    if (chunk->pipeline.last_visible.time_since_epoch().count() == 0)
+      ImGui::Text("Last visible: never");
+    else
+      ImGui::Text("Last visible: %.1f s ago", seen_s);
+    ImGui::Text("Uploads: %d", chunk->pipeline.uploads);
+  }
+
+  uint64_t idle = 0;
+  if (const auto *gpu = residency.peek(kind, cx, cy, &idle))
+    ImGui::Text("GPU: %.1f KB, drawn %llu frames ago", gpu->bytes / 1024.0, (unsigned long long)idle);
+  ImGui::EndTooltip();
+}
+} // namespace
+
+auto chunk_pipeline_overlay_t::draw(const world_t &world, const chunk_renderer_t &renderer, const glm::vec2 &camera_pos) -> void
+{
+  if (!visible)
+    return;
+
+  const auto &residency = renderer.get_residency();
+  const auto kind = renderer.get_gpu_kind(); // Mesh or cached texture, whichever is being drawn
+  const int center_x = floor_div((int)std::floor(camera_pos.x), chunk_t::SIZE);
+  const int center_y = floor_div((int)std::floor(camera_pos.y), chunk_t::SIZE);
+  const int side = radius * 2 + 1;
+
+  ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f), ImGuiCond_FirstUseEver);
+  if (!ImGui::Begin("Chunk Pipeline", &visible, ImGuiWindowFlags_AlwaysAutoResize))
+  {
+    ImGui::End();
+    return;
+  }
+
+  const auto &gpu = residency.get_stats();
+  ImGui::Text("Loaded %zu  pending %zu", world.get_loaded_chunk_count(), world.get_pending_chunk_count());
+  ImGui::Text("VRAM %.1f / %.1f MB  uploads %zu  evictions %zu", gpu.resident_bytes / 1048576.0, gpu.budget_bytes / 1048576.0, gpu.uploads, gpu.evictions);
+  ImGui::SliderInt("Radius", &radius, 2, 24);
+
+  ImDrawList *draw_list = ImGui::GetWindowDrawList();
+  const ImVec2 origin = ImGui::GetCursorScreenPos();
+  const ImVec2 mouse = ImGui::GetIO().MousePos;
+  std::array<int, (int)pipeline_state_e::count> counts = {};
+  bool hovered = false;
+  int hover_x = 0, hover_y = 0;
+  pipeline_state_e hover_state = pipeline_state_e::none;
+
+  for (int row = 0; row < side; row++)
+  {
+    for (int col = 0; col < side; col++)
+    {
+      // Top row is the highest chunk (world Y is up)
+      const int cx = center_x - radius + col;
+      const int cy = center_y + radius - row;
+      const pipeline_state_e state = classify(world, residency, kind, cx, cy);
+      counts[(int)state]++;
+
+      ImVec2 a(origin.x + col * cell_size, origin.y + row * cell_size);
+      ImVec2 b(a.x + cell_size - 1.0f, a.y + cell_size - 1.0f);
+      draw_list->AddRectFilled(a, b, styles[(int)state].color);
+      if (cx == center_x && cy == center_y)
+        draw_list->AddRect(a, b, IM_COL32(255, 255, 255, 255), 0.0f, 0, 2.0f);
+
+      if (mouse.x >= a.x && mouse.x < b.x && mouse.y >= a.y && mouse.y < b.y)
+      {
+        hovered = true;
+        hover_x = cx;
+        hover_y = cy;
+        hover_state = state;
+        draw_list->AddRect(a, b, IM_COL32(255, 255, 0, 255));
+      }
+    }
+  }
+  ImGui::Dummy(ImVec2(side * cell_size, side * cell_size));
+
+  if (hovered && ImGui::IsWindowHovered())
+    draw_details(world, residency, kind, hover_x, hover_y, hover_state);
+
+  // Legend with counts
+  for (int s = 0; s < (int)pipeline_state_e::count; s++)
+  {
+    ImGui::ColorButton(styles[s].name, ImGui::ColorConvertU32ToFloat4(styles[s].color), ImGuiColorEditFlags_NoTooltip, ImVec2(10.0f, 10.0f));
+    ImGui::SameLine();
+    ImGui::Text("%s %d", styles[s].name, counts[s]);
+    if (s % 4 != 3)
+      ImGui::SameLine();
+  }
+
+  ImGui::End();
+}
+
+} // namespace deepbound
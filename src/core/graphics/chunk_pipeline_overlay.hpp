@@ -0,0 +1,30 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace deepbound
+{
+
+class world_t;
+class chunk_renderer_t;
+
+/**
+ * @brief ImGui window showing the chunks around the camera coloured by pipeline state.
+ *
+ * Requested -> generating -> generated -> meshed -> uploaded, plus cold (on the GPU but not drawn
+ * this frame) and evicted (was uploaded, dropped by the VRAM budget). Hovering a cell shows timings,
+ * sizes and upload counts, so stuck requests, chunks generated and never drawn, and upload thrash
+ * stand out. Read only: it never requests chunks or touches residency.
+ */
+class chunk_pipeline_overlay_t
+{
+public:
+  // Between ImGui::NewFrame() and ImGui::Render(), after the frame's chunks were rendered
+  auto draw(const world_t &world, const chunk_renderer_t &renderer, const glm::vec2 &camera_pos) -> void;
+
+  bool visible = false;
+  int radius = 8; // Chunks shown around the camera
+  float cell_size = 14.0f;
+};
+
+} // namespace deepbound
@@ -3,8 +3,13 @@
 #include <glad/glad.h>
 
 #include "core/assets/asset_manager.hpp"
+#include "core/common/metrics.hpp"
 #include "core/worldgen/world.hpp"
+#include "core/content/autotile.hpp"
 #include "core/content/tile.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
 
 namespace deepbound
 {
@@ -90,19 +95,80 @@ void main() {
 }
 )";
 
-chunk_renderer_t::chunk_renderer_t()
-{
-  // Setup Shader
-  m_shader = std::make_unique<shader_t>(vertex_shader_src, fragment_shader_src);
+// Texture cache: one quad per chunk sampling its baked texture
+const std::string cache_vertex_shader_src = R"(
+#version 330 core
+layout (location = 0) in vec2 aPos; // Unit quad
+
+out vec2 TexCoord;
+
+uniform vec2 uScale = vec2(1.0, 1.0);
+uniform vec2 uOffset = vec2(0.0, 0.0);
+uniform float uZoom = 1.0;
+uniform vec2 uOrigin; // Chunk corner in tiles
+uniform float uSize;  // Chunk edge in tiles
+
+void main() {
+    vec2 pos = (uOrigin + aPos * uSize - uOffset) * uZoom;
+    gl_Position = vec4(pos * uScale, 0.0, 1.0);
+    TexCoord = aPos;
+}
+)";
+
+const std::string cache_fragment_shader_src = R"(
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D uChunk;
+
+void main() {
+    vec4 color = texture(uChunk, TexCoord);
+    if(color.a < 0.1)
+        discard;
+    FragColor = color;
+}
+)";
 
-  // Setup Geometry placeholders
-  glGenVertexArrays(1, &m_vao);
-  glGenBuffers(1, &m_vbo);
+namespace
+{
+struct renderer_metrics_t
+{
+  metric_histogram_t &mesh_seconds = metrics_t::get().histogram("deepbound_chunk_mesh_seconds", "Time to build one chunk mesh", metrics_t::seconds_buckets());
+  metric_histogram_t &bake_seconds = metrics_t::get().histogram("deepbound_chunk_bake_seconds", "Time to render one chunk into its cached texture", metrics_t::seconds_buckets());
+  metric_gauge_t &vram = metrics_t::get().gauge("deepbound_memory_bytes", "Approximate memory use per subsystem", {{"subsystem", "gpu_chunk_meshes"}});
+  metric_gauge_t &vram_budget = metrics_t::get().gauge("deepbound_gpu_budget_bytes", "VRAM budget for chunk meshes");
+  metric_gauge_t &over_budget = metrics_t::get().gauge("deepbound_gpu_over_budget", "1 when the visible chunks alone exceed the VRAM budget");
+};
+
+auto renderer_metrics() -> renderer_metrics_t &
+{
+  static renderer_metrics_t metrics;
+  return metrics;
+}
 
-  glBindVertexArray(m_vao);
-  glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+// Texels per tile edge at native resolution: the widest tile texture in the atlas, so no tile is
+// scaled down. 16 if no tile has a texture yet.
+auto native_tile_texels() -> int
+{
+  auto &assets = asset_manager_t::get();
+  const float atlas_width = (float)assets.get_atlas_texture("tiles").get_width();
+  int texels = 0;
+  for (const auto &[id, tile] : tile_registry_t::get().get_all_tiles())
+  {
+    for (const auto &[face, texture] : tile.textures)
+    {
+      uv_rect_t uv = assets.get_texture_uvs("tiles", texture);
+      texels = std::max(texels, (int)std::lround((uv.u2 - uv.u1) * atlas_width));
+    }
+  }
+  return texels > 0 ? std::min(texels, 64) : 16;
+}
 
-  // Vertex attributes: Pos(2), UV(2), Climate(2), TintId(1) = 7 floats
+// Vertex attributes for the bound VAO/VBO: Pos(2), UV(2), Climate(2), TintId(1) = 7 floats
+auto setup_vertex_layout() -> void
+{
   int stride = 7 * sizeof(float);
   glEnableVertexAttribArray(0);
   glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void *)0);
@@ -117,11 +183,51 @@ chunk_renderer_t::chunk_renderer_t()
   glEnableVertexAttribArray(3);
   glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (void *)(6 * sizeof(float)));
 }
+} // namespace
+
+chunk_renderer_t::chunk_renderer_t(size_t vram_budget_bytes) : m_residency(vram_budget_bytes)
+{
+  // Setup Shader
+  m_shader = std::make_unique<shader_t>(vertex_shader_src, fragment_shader_src);
+}
 
 chunk_renderer_t::~chunk_renderer_t()
 {
-  glDeleteBuffers(1, &m_vbo);
-  glDeleteVertexArrays(1, &m_vao);
+  // Cached textures themselves belong to m_residency
+  if (m_cache_fbo)
+    glDeleteFramebuffers(1, &m_cache_fbo);
+  if (m_quad_vao)
+    glDeleteVertexArrays(1, &m_quad_vao);
+  if (m_quad_vbo)
+    glDeleteBuffers(1, &m_quad_vbo);
+  if (m_bake_vao)
+    glDeleteVertexArrays(1, &m_bake_vao);
+  if (m_bake_vbo)
+    glDeleteBuffers(1, &m_bake_vbo);
+}
+
+auto chunk_renderer_t::begin_frame(size_t visible_chunks) -> void
+{
+  // Last frame's totals, before eviction starts the next one
+  const auto &stats = m_residency.get_stats();
+  auto &metrics = renderer_metrics();
+  metrics.vram.set((double)stats.resident_bytes);
+  metrics.vram_budget.set((double)stats.budget_bytes);
+  metrics.over_budget.set(stats.over_budget ? 1.0 : 0.0);
+
+  m_residency.begin_frame();
+
+  // Before anything is baked this frame; textures baked at another resolution are stale
+  m_visible_chunks = visible_chunks;
+  if (m_mode == mode_e::texture_cache && m_native_tile_texels > 0)
+  {
+    const int texels = fit_tile_texels();
+    if (texels != m_tile_texels)
+    {
+      m_residency.release_all(gpu_residency_t::kind_e::chunk_texture);
+      m_tile_texels = texels;
+    }
+  }
 }
 
 auto chunk_renderer_t::render(chunk_t &chunk, const camera_2d_t &camera, float aspect_ratio) -> void
@@ -198,10 +304,9 @@ auto chunk_renderer_t::render(chunk_t &chunk, const camera_2d_t &camera, float a
   if (locZoom != -1)
     glUniform1f(locZoom, camera.get_zoom());
 
-  glBindVertexArray(m_vao);
-
   if (chunk.is_mesh_dirty())
   {
+    metric_timer_t mesh_timer(renderer_metrics().mesh_seconds);
     std::vector<float> vertices;
     vertices.reserve(chunk_t::SIZE * chunk_t::SIZE * 42); // Reserved 7 floats * 6 verts * blocks
 
@@ -250,6 +355,17 @@ auto chunk_renderer_t::render(chunk_t &chunk, const camera_2d_t &camera, float a
           uvs = asset_manager_t::get().get_texture_uvs("tiles", def->id);
         }
 
+        // Edge/corner variant from the connectivity mask
+        auto apply_autotile = [&](uv_rect_t &uv)
+        {
+          if (def->autotile_variants.empty())
+            return;
+          int variant = autotile_variant(chunk.autotile.get_mask(x, y), def->autotile_connectivity);
+          if (variant < (int)def->autotile_variants.size() && !def->autotile_variants[variant].get_path().empty())
+            uv = asset_manager_t::get().get_texture_uvs("tiles", def->autotile_variants[variant]);
+        };
+        apply_autotile(uvs);
+
         float gx = chunk_world_x + (float)x;
         float gy = chunk_world_y + (float)y;
 
@@ -276,6 +392,7 @@ auto chunk_renderer_t::render(chunk_t &chunk, const camera_2d_t &camera, float a
           {
             base_uv = asset_manager_t::get().get_texture_uvs("tiles", def->id);
           }
+          apply_autotile(base_uv);
           push_quad(base_uv, 0.0f);
 
           // 2. Special Second Texture (Tinted) - "Side" overlay
@@ -307,20 +424,234 @@ auto chunk_renderer_t::render(chunk_t &chunk, const camera_2d_t &camera, float a
         }
       }
     }
+
+    // Liquids over the tiles, visiting only sections that hold any. A partly filled cell is drawn
+    // as high as its level, unless more liquid sits on it.
+    const auto &tile_registry = tile_registry_t::get();
+    chunk.liquids.for_each(
+        [&](int x, int y, liquid_cell_t cell)
+        {
+          const tile_definition_t *def = tile_registry.get_tile_by_runtime_id(cell.type);
+          if (!def)
+            return;
+
+          uv_rect_t uv = {0, 0, 0, 0};
+          if (def->textures.contains("all"))
+            uv = asset_manager_t::get().get_texture_uvs("tiles", def->textures.at("all"));
+          else if (!def->textures.empty())
+            uv = asset_manager_t::get().get_texture_uvs("tiles", def->textures.begin()->second);
+          else
+            uv = asset_manager_t::get().get_texture_uvs("tiles", def->id);
+
+          auto clim = chunk.get_climate(x, y);
+          float n_temp = std::clamp((clim.temp + 50.0f) / 100.0f, 0.0f, 1.0f);
+          float n_rain = std::clamp(clim.rain / 255.0f, 0.0f, 1.0f);
+          auto tint = tint_slots.find(def->climate_color_map);
+          float t_id = (tint != tint_slots.end()) ? (float)tint->second : 0.0f;
+
+          float height = chunk.get_liquid_around(x, y + 1).empty() ? cell.level / 255.0f : 1.0f;
+          float gx = chunk_world_x + (float)x;
+          float gy = chunk_world_y + (float)y;
+          float top = gy + height;
+          float v_top = uv.v2 + (uv.v1 - uv.v2) * height;
+          vertices.insert(vertices.end(), {gx, gy, uv.u1, uv.v2, n_temp, n_rain, t_id, gx + 1.0f, gy,  uv.u2, uv.v2, n_temp, n_rain, t_id, gx + 1.0f, top, uv.u2, v_top, n_temp, n_rain, t_id,
+                                           gx, gy, uv.u1, uv.v2, n_temp, n_rain, t_id, gx + 1.0f, top, uv.u2, v_top, n_temp, n_rain, t_id, gx,        top, uv.u1, v_top, n_temp, n_rain, t_id});
+        });
     chunk.set_mesh(std::move(vertices));
   }
 
+  if (m_mode == mode_e::texture_cache)
+  {
+    // Baked textures hold the tints and atlas texels of their bake; any change there makes all of them stale
+    const auto &atlas = asset_manager_t::get().get_atlas_texture("tiles");
+    tint_uv_array.insert(tint_uv_array.end(), {(float)atlas.get_id(), (float)atlas.get_width(), (float)atlas.get_height()});
+    if (tint_uv_array != m_tint_signature)
+    {
+      m_residency.release_all(gpu_residency_t::kind_e::chunk_texture);
+      m_tint_signature = std::move(tint_uv_array);
+      m_native_tile_texels = native_tile_texels();
+      m_tile_texels = fit_tile_texels();
+    }
+
+    if (draw_cached(chunk, camera, scale_x, scale_y))
+      return;
+    std::cerr << "Chunk texture cache unavailable, drawing meshes" << std::endl;
+    m_mode = mode_e::mesh;
+    m_shader->bind();
+  }
+
   const auto &mesh = chunk.get_mesh();
+  const auto kind = gpu_residency_t::kind_e::chunk_mesh;
   if (mesh.empty())
+  {
+    m_residency.release(kind, chunk.get_x(), chunk.get_y());
     return;
+  }
 
-  // std::cout << "Render: " << chunk.get_x() << "," << chunk.get_y() << " V:" << mesh.size() / 7 << std::endl;
+  // Upload only if the GPU copy is missing (new or evicted) or older than the mesh
+  auto *gpu = m_residency.find(kind, chunk.get_x(), chunk.get_y());
+  if (!gpu || gpu->version != chunk.mesh_version)
+  {
+    gpu = &m_residency.acquire(kind, chunk.get_x(), chunk.get_y(), mesh.size() * sizeof(float));
+    if (!gpu->vao)
+    {
+      glGenVertexArrays(1, &gpu->vao);
+      glGenBuffers(1, &gpu->vbo);
+      glBindVertexArray(gpu->vao);
+      glBindBuffer(GL_ARRAY_BUFFER, gpu->vbo);
+      setup_vertex_layout();
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, gpu->vbo);
+    glBufferData(GL_ARRAY_BUFFER, mesh.size() * sizeof(float), mesh.data(), GL_STATIC_DRAW);
+    gpu->count = mesh.size() / 7; // 7 floats per vertex
+    gpu->version = chunk.mesh_version;
+    chunk.pipeline.uploaded_version = chunk.mesh_version;
+    chunk.pipeline.uploads++;
+  }
+
+  glBindVertexArray(gpu->vao);
+  glDrawArrays(GL_TRIANGLES, 0, (GLsizei)gpu->count);
+}
 
-  glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-  glBufferData(GL_ARRAY_BUFFER, mesh.size() * sizeof(float), mesh.data(), GL_STATIC_DRAW);
+auto chunk_renderer_t::init_cache() -> bool
+{
+  if (m_cache_fbo)
+    return true;
+
+  m_cache_shader = std::make_unique<shader_t>(cache_vertex_shader_src, cache_fragment_shader_src);
+  glGenFramebuffers(1, &m_cache_fbo);
+
+  const float quad[] = {0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f};
+  glGenVertexArrays(1, &m_quad_vao);
+  glGenBuffers(1, &m_quad_vbo);
+  glBindVertexArray(m_quad_vao);
+  glBindBuffer(GL_ARRAY_BUFFER, m_quad_vbo);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
+
+  glGenVertexArrays(1, &m_bake_vao);
+  glGenBuffers(1, &m_bake_vbo);
+  glBindVertexArray(m_bake_vao);
+  glBindBuffer(GL_ARRAY_BUFFER, m_bake_vbo);
+  setup_vertex_layout();
+  return m_cache_fbo != 0;
+}
+
+// Native resolution, halved until a texture for every visible chunk fits the budget. Otherwise the
+// LRU would evict textures still needed next frame and keep baking them again.
+auto chunk_renderer_t::fit_tile_texels() const -> int
+{
+  const size_t budget = m_residency.get_stats().budget_bytes;
+  int texels = m_native_tile_texels;
+  while (texels > 1)
+  {
+    const size_t edge = (size_t)chunk_t::SIZE * texels;
+    if (m_visible_chunks * edge * edge * 4 <= budget)
+      break;
+    texels /= 2;
+  }
+  return texels;
+}
+
+auto chunk_renderer_t::bake(const chunk_t &chunk, unsigned int texture, int texels) -> bool
+{
+  metric_timer_t bake_timer(renderer_metrics().bake_seconds);
+
+  GLint previous_fbo = 0;
+  GLint viewport[4];
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous_fbo);
+  glGetIntegerv(GL_VIEWPORT, viewport);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, m_cache_fbo);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+  const bool ok = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+  if (ok)
+  {
+    glViewport(0, 0, texels, texels);
+    const float transparent[] = {0.0f, 0.0f, 0.0f, 0.0f};
+    glClearBufferfv(GL_COLOR, 0, transparent);
+
+    // The tile shader with the chunk's square mapped onto the whole texture; tint and atlas
+    // uniforms are already set for this frame
+    const float size = (float)chunk_t::SIZE;
+    const unsigned int id = m_shader->get_renderer_id();
+    m_shader->bind();
+    asset_manager_t::get().get_atlas_texture("tiles").bind(0); // Creating the target texture rebound unit 0
+    glUniform2f(glGetUniformLocation(id, "uScale"), 2.0f / size, 2.0f / size);
+    glUniform2f(glGetUniformLocation(id, "uOffset"), (float)chunk.get_x() * size + size * 0.5f, (float)chunk.get_y() * size + size * 0.5f);
+    glUniform1f(glGetUniformLocation(id, "uZoom"), 1.0f);
+
+    const auto &mesh = chunk.get_mesh();
+    glBindVertexArray(m_bake_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_bake_vbo);
+    glBufferData(GL_ARRAY_BUFFER, mesh.size() * sizeof(float), mesh.data(), GL_STREAM_DRAW);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(mesh.size() / 7));
+  }
+
+  glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)previous_fbo);
+  glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+  return ok;
+}
+
+auto chunk_renderer_t::draw_cached(chunk_t &chunk, const camera_2d_t &camera, float scale_x, float scale_y) -> bool
+{
+  const auto &mesh = chunk.get_mesh();
+  const auto kind = gpu_residency_t::kind_e::chunk_texture;
+  const int cx = chunk.get_x();
+  const int cy = chunk.get_y();
+  if (mesh.empty())
+  {
+    m_residency.release(kind, cx, cy);
+    m_residency.release(gpu_residency_t::kind_e::chunk_mesh, cx, cy);
+    return true;
+  }
+  if (!init_cache())
+    return false;
+
+  const int texels = chunk_t::SIZE * m_tile_texels;
+
+  auto *gpu = m_residency.find(kind, cx, cy);
+  if (!gpu || gpu->version != chunk.mesh_version)
+  {
+    gpu = &m_residency.acquire(kind, cx, cy, (size_t)texels * texels * 4);
+    if (!gpu->texture)
+    {
+      glGenTextures(1, &gpu->texture);
+      glBindTexture(GL_TEXTURE_2D, gpu->texture);
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, texels, texels, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      gpu->count = (size_t)texels * texels;
+    }
+    if (!bake(chunk, gpu->texture, texels))
+    {
+      m_residency.release(kind, cx, cy);
+      return false;
+    }
+    gpu->version = chunk.mesh_version;
+    chunk.pipeline.uploaded_version = chunk.mesh_version;
+    chunk.pipeline.uploads++;
+    // The mesh isn't drawn in this mode, so its VRAM goes back to the budget
+    m_residency.release(gpu_residency_t::kind_e::chunk_mesh, cx, cy);
+  }
 
-  // 7 floats per vertex now
-  glDrawArrays(GL_TRIANGLES, 0, mesh.size() / 7);
+  m_cache_shader->bind();
+  const unsigned int id = m_cache_shader->get_renderer_id();
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, gpu->texture);
+  glUniform1i(glGetUniformLocation(id, "uChunk"), 0);
+  glUniform2f(glGetUniformLocation(id, "uScale"), scale_x, scale_y);
+  glUniform2f(glGetUniformLocation(id, "uOffset"), camera.get_position().x, camera.get_position().y);
+  glUniform1f(glGetUniformLocation(id, "uZoom"), camera.get_zoom());
+  glUniform2f(glGetUniformLocation(id, "uOrigin"), (float)cx * chunk_t::SIZE, (float)cy * chunk_t::SIZE);
+  glUniform1f(glGetUniformLocation(id, "uSize"), (float)chunk_t::SIZE);
+
+  glBindVertexArray(m_quad_vao);
+  glDrawArrays(GL_TRIANGLES, 0, 6);
+  return true;
 }
 
 } // namespace deepbound
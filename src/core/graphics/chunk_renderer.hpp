@@ -2,6 +2,7 @@
 
 #include <memory>
 #include "core/graphics/camera.hpp"
+#include "core/graphics/gpu_residency.hpp"
 #include "core/graphics/shader.hpp"
 #include "core/worldgen/world.hpp"
 #include <vector>
@@ -12,17 +13,74 @@ namespace deepbound
 class chunk_renderer_t
 {
 public:
-  chunk_renderer_t();
+  enum class mode_e : uint8_t
+  {
+    mesh,         // Draws every tile quad of the chunk mesh each frame
+    texture_cache // Bakes each chunk into a texture once, then draws one quad per chunk
+  };
+
+  chunk_renderer_t(size_t vram_budget_bytes = 256ull * 1024 * 1024);
   ~chunk_renderer_t();
 
+  // In texture_cache mode a chunk is baked again only when its mesh changes (edits, regeneration)
+  // or the tint maps / atlas change. Textures share the VRAM budget with meshes.
+  auto set_mode(mode_e mode) -> void
+  {
+    m_mode = mode;
+  }
+  auto get_mode() const -> mode_e
+  {
+    return m_mode;
+  }
+  // The resource kind drawn in the current mode
+  auto get_gpu_kind() const -> gpu_residency_t::kind_e
+  {
+    return m_mode == mode_e::texture_cache ? gpu_residency_t::kind_e::chunk_texture : gpu_residency_t::kind_e::chunk_mesh;
+  }
+
+  // Once per frame, before the first render(). `visible_chunks` is the most chunks this frame will
+  // render (the whole view square); texture_cache mode lowers the texture resolution until that
+  // many textures fit the VRAM budget together. 0 = unknown, keep native resolution.
+  auto begin_frame(size_t visible_chunks = 0) -> void;
   auto render(chunk_t &chunk, const camera_2d_t &camera, float aspect_ratio = 1.0f) -> void;
 
+  // Chunk meshes stay on the GPU between frames, within this budget
+  auto get_residency() -> gpu_residency_t &
+  {
+    return m_residency;
+  }
+  auto get_residency() const -> const gpu_residency_t &
+  {
+    return m_residency;
+  }
+  // Texels per tile edge of the cached textures, 0 before the first texture_cache frame
+  auto get_tile_texels() const -> int
+  {
+    return m_tile_texels;
+  }
+
 private:
-  unsigned int m_vao;
-  unsigned int m_vbo;
-  unsigned int m_ebo; // If using indices
+  // Draws the chunk's cached texture, baking it first if stale. False if it can't (no FBO support).
+  auto draw_cached(chunk_t &chunk, const camera_2d_t &camera, float scale_x, float scale_y) -> bool;
+  auto bake(const chunk_t &chunk, unsigned int texture, int texels) -> bool;
+  auto init_cache() -> bool;
+  auto fit_tile_texels() const -> int;
 
   std::unique_ptr<shader_t> m_shader;
+  gpu_residency_t m_residency;
+  mode_e m_mode = mode_e::mesh;
+
+  // Texture cache state, created on first use
+  std::unique_ptr<shader_t> m_cache_shader;
+  unsigned int m_cache_fbo = 0;
+  unsigned int m_quad_vao = 0;
+  unsigned int m_quad_vbo = 0;
+  unsigned int m_bake_vao = 0; // Streams the mesh of the chunk being baked
+  unsigned int m_bake_vbo = 0;
+  int m_native_tile_texels = 0;        // Texels per tile edge in the atlas, set with the signature
+  int m_tile_texels = 0;               // Texels per tile edge baked, native or lower to fit the budget
+  size_t m_visible_chunks = 0;         // From begin_frame
+  std::vector<float> m_tint_signature; // Tint UVs and atlas the cached textures were baked with
 };
 
 } // namespace deepbound
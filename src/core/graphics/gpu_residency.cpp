@@ -0,0 +1,179 @@
+#include "core/graphics/gpu_residency.hpp"
+#include "core/common/metrics.hpp"
+#include <algorithm>
+#include <GLFW/glfw3.h>
+#include <glad/glad.h>
+
+namespace deepbound
+{
+
+namespace
+{
+struct residency_metrics_t
+{
+  metric_counter_t &hits = metrics_t::get().counter("deepbound_gpu_cache_lookups_total", "GPU resource lookups by result", {{"result", "hit"}});
+  metric_counter_t &misses = metrics_t::get().counter("deepbound_gpu_cache_lookups_total", "GPU resource lookups by result", {{"result", "miss"}});
+  metric_counter_t &uploads = metrics_t::get().counter("deepbound_gpu_uploads_total", "GPU resource (re)uploads");
+  metric_counter_t &evictions = metrics_t::get().counter("deepbound_gpu_evictions_total", "GPU resources evicted by the VRAM budget");
+};
+
+auto residency_metrics() -> residency_metrics_t &
+{
+  static residency_metrics_t metrics;
+  return metrics;
+}
+} // namespace
+
+gpu_residency_t::gpu_residency_t(size_t budget_bytes)
+{
+  m_stats.budget_bytes = budget_bytes;
+}
+
+gpu_residency_t::~gpu_residency_t()
+{
+  clear();
+}
+
+auto gpu_residency_t::make_key(kind_e kind, int cx, int cy) -> uint64_t
+{
+  // 28 bits per coordinate is +-134M chunks, far past anything the generator reaches
+  return ((uint64_t)kind << 56) | (((uint64_t)(uint32_t)cx & 0x0fffffffull) << 28) | ((uint64_t)(uint32_t)cy & 0x0fffffffull);
+}
+
+auto gpu_residency_t::begin_frame() -> void
+{
+  m_frame++;
+  m_stats.over_budget = false;
+  evict_until(0);
+}
+
+auto gpu_residency_t::touch(lru_t::iterator it) -> void
+{
+  it->last_frame = m_frame;
+  m_lru.splice(m_lru.begin(), m_lru, it);
+}
+
+auto gpu_residency_t::find(kind_e kind, int cx, int cy) -> resource_t *
+{
+  auto it = m_index.find(make_key(kind, cx, cy));
+  if (it == m_index.end())
+  {
+    residency_metrics().misses.add();
+    return nullptr;
+  }
+  residency_metrics().hits.add();
+  touch(it->second);
+  return &it->second->resource;
+}
+
+auto gpu_residency_t::peek(kind_e kind, int cx, int cy, uint64_t *frames_idle) const -> const resource_t *
+{
+  auto it = m_index.find(make_key(kind, cx, cy));
+  if (it == m_index.end())
+    return nullptr;
+  if (frames_idle)
+    *frames_idle = m_frame - it->second->last_frame;
+  return &it->second->resource;
+}
+
+auto gpu_residency_t::acquire(kind_e kind, int cx, int cy, size_t bytes) -> resource_t &
+{
+  const uint64_t key = make_key(kind, cx, cy);
+  auto it = m_index.find(key);
+  if (it != m_index.end())
+  {
+    touch(it->second);
+    m_stats.resident_bytes -= it->second->resource.bytes;
+    it->second->resource.bytes = 0;
+  }
+
+  evict_until(bytes);
+
+  if (it == m_index.end())
+  {
+    m_lru.push_front({key, m_frame, {}});
+    it = m_index.emplace(key, m_lru.begin()).first;
+  }
+
+  resource_t &resource = it->second->resource;
+  resource.bytes = bytes;
+  m_stats.resident_bytes += bytes;
+  m_stats.peak_bytes = std::max(m_stats.peak_bytes, m_stats.resident_bytes);
+  m_stats.resident_count = m_lru.size();
+  m_stats.uploads++;
+  residency_metrics().uploads.add();
+  m_stats.over_budget = m_stats.over_budget || m_stats.resident_bytes > m_stats.budget_bytes;
+  return resource;
+}
+
+auto gpu_residency_t::evict_until(size_t bytes_needed) -> void
+{
+  // Oldest first, stopping at anything drawn this frame
+  while (!m_lru.empty() && m_stats.resident_bytes + bytes_needed > m_stats.budget_bytes && m_lru.back().last_frame < m_frame)
+  {
+    destroy(m_lru.back());
+    m_index.erase(m_lru.back().key);
+    m_lru.pop_back();
+    m_stats.evictions++;
+    residency_metrics().evictions.add();
+  }
+  m_stats.resident_count = m_lru.size();
+}
+
+auto gpu_residency_t::destroy(entry_t &entry) -> void
+{
+  resource_t &r = entry.resource;
+  if (r.vao)
+    glDeleteVertexArrays(1, &r.vao);
+  if (r.vbo)
+    glDeleteBuffers(1, &r.vbo);
+  if (r.texture)
+    glDeleteTextures(1, &r.texture);
+  m_stats.resident_bytes -= r.bytes;
+  r = {};
+}
+
+auto gpu_residency_t::release(kind_e kind, int cx, int cy) -> void
+{
+  auto it = m_index.find(make_key(kind, cx, cy));
+  if (it == m_index.end())
+    return;
+  destroy(*it->second);
+  m_lru.erase(it->second);
+  m_index.erase(it);
+  m_stats.resident_count = m_lru.size();
+}
+
+auto gpu_residency_t::release_all(kind_e kind) -> void
+{
+  for (auto it = m_lru.begin(); it != m_lru.end();)
+  {
+    if ((it->key >> 56) != (uint64_t)kind)
+    {
+      ++it;
+      continue;
+    }
+    destroy(*it);
+    m_index.erase(it->key);
+    it = m_lru.erase(it);
+  }
+  m_stats.resident_count = m_lru.size();
+}
+
+auto gpu_residency_t::clear() -> void
+{
+  for (auto &entry : m_lru)
+    destroy(entry);
+  m_lru.clear();
+  m_index.clear();
+  m_stats.resident_count = 0;
+  m_stats.peak_bytes = 0;
+}
+
+auto gpu_residency_t::set_budget(size_t budget_bytes) -> void
+{
+  m_stats.budget_bytes = budget_bytes;
+  evict_until(0);
+}
+
+} // namespace deepbound
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+namespace deepbound
+{
+
+/**
+ * @brief Tracks the GPU copies of per-chunk resources and keeps them under a VRAM budget.
+ *
+ * GPU resources live independently of the chunk_t they were built from: when an upload would go
+ * over budget, the least recently drawn resources are deleted while the CPU chunk stays loaded, and
+ * the next draw simply uploads again. Resources used in the current frame are never evicted, so a
+ * view that needs more than the budget overshoots it (see stats_t::over_budget) instead of thrashing.
+ * Call begin_frame() once per frame. Owns the GL objects it hands out; needs the GL context.
+ */
+class gpu_residency_t
+{
+public:
+  enum class kind_e : uint8_t
+  {
+    chunk_mesh,
+    chunk_texture
+  };
+
+  // GL handles of one resident resource, zero until created by the caller
+  struct resource_t
+  {
+    unsigned int vao = 0;
+    unsigned int vbo = 0;
+    unsigned int texture = 0;
+    size_t count = 0;     // Vertices or texels, whatever the caller needs to draw it
+    uint64_t version = 0; // Of the CPU data last uploaded, 0 = nothing uploaded yet
+    size_t bytes = 0;
+  };
+
+  struct stats_t
+  {
+    size_t budget_bytes = 0;
+    size_t resident_bytes = 0;
+    size_t peak_bytes = 0;
+    size_t resident_count = 0;
+    size_t uploads = 0;
+    size_t evictions = 0;
+    bool over_budget = false; // This frame's resources alone exceed the budget
+  };
+
+  explicit gpu_residency_t(size_t budget_bytes = 256ull * 1024 * 1024);
+  ~gpu_residency_t();
+
+  gpu_residency_t(const gpu_residency_t &) = delete;
+  gpu_residency_t &operator=(const gpu_residency_t &) = delete;
+
+  auto begin_frame() -> void;
+
+  // Resident resource, marked as drawn this frame; null if it isn't on the GPU
+  auto find(kind_e kind, int cx, int cy) -> resource_t *;
+
+  // Finds or adds the resource and marks it drawn. Call before (re)uploading `bytes`: makes room
+  // by evicting older resources and updates the accounting.
+  auto acquire(kind_e kind, int cx, int cy, size_t bytes) -> resource_t &;
+
+  // Same as find() but doesn't count as a draw; frames_idle gets the frames since it was last drawn
+  auto peek(kind_e kind, int cx, int cy, uint64_t *frames_idle = nullptr) const -> const resource_t *;
+
+  auto release(kind_e kind, int cx, int cy) -> void;
+  auto release_all(kind_e kind) -> void;
+  auto clear() -> void;
+
+  auto set_budget(size_t budget_bytes) -> void;
+  auto get_stats() const -> const stats_t &
+  {
+    return m_stats;
+  }
+
+private:
+  struct entry_t
+  {
+    uint64_t key;
+    uint64_t last_frame;
+    resource_t resource;
+  };
+  using lru_t = std::list<entry_t>; // Most recently drawn first
+
+  static auto make_key(kind_e kind, int cx, int cy) -> uint64_t;
+  auto touch(lru_t::iterator it) -> void;
+  auto evict_until(size_t bytes_needed) -> void;
+  auto destroy(entry_t &entry) -> void;
+
+  lru_t m_lru;
+  std::unordered_map<uint64_t, lru_t::iterator> m_index;
+  uint64_t m_frame = 1;
+  stats_t m_stats;
+};
+
+} // namespace deepbound
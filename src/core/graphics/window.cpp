@@ -29,6 +29,10 @@ auto window_t::init(const properties_t &props) -> void
 
   if (!s_glfw_initialized)
   {
+    // OSMesa needs no display server at all
+    if (m_data.context_api == context_api_e::osmesa)
+      glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+
     int success = glfwInit();
     if (!success)
     {
@@ -40,9 +44,15 @@ auto window_t::init(const properties_t &props) -> void
   }
 
   // Set context version (e.g. 4.6 Core)
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, m_data.gl_major);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, m_data.gl_minor);
   glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+  glfwWindowHint(GLFW_VISIBLE, m_data.visible ? GLFW_TRUE : GLFW_FALSE);
+
+  if (m_data.context_api == context_api_e::egl)
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+  else if (m_data.context_api == context_api_e::osmesa)
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
 
   m_window = glfwCreateWindow(m_data.width, m_data.height, m_data.title.c_str(), nullptr, nullptr);
 
@@ -12,6 +12,13 @@ namespace deepbound
 class window_t
 {
 public:
+  enum class context_api_e
+  {
+    native,
+    egl,
+    osmesa // Software rendering without a display (GLFW null platform)
+  };
+
   struct properties_t
   {
     std::string title;
@@ -19,6 +26,12 @@ public:
     int height;
     bool vsync;
     std::function<void(double, double)> scroll_callback;
+
+    // Headless use (benchmarks): a hidden window, or an offscreen context
+    bool visible = true;
+    context_api_e context_api = context_api_e::native;
+    int gl_major = 4;
+    int gl_minor = 6;
   };
 
   window_t(const properties_t &props);
@@ -28,6 +41,10 @@ public:
   auto update() -> void;
   auto swap_buffers() -> void;
 
+  auto is_valid() const -> bool
+  {
+    return m_window != nullptr;
+  }
   auto get_native_window() const -> GLFWwindow *
   {
     return m_window;
@@ -0,0 +1,138 @@
+#include "core/worldgen/aquifer_map.hpp"
+#include "core/worldgen/coord_hash.hpp"
+#include "core/worldgen/floor_div.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace deepbound
+{
+
+namespace
+{
+// Continuous cell coordinate of a tile centre relative to cell centres
+auto cell_coord(int tile, int cell_size) -> float
+{
+  return ((float)tile + 0.5f) / (float)cell_size - 0.5f;
+}
+} // namespace
+
+auto aquifer_map_t::configure(const settings_t &settings, int seed) -> void
+{
+  m_settings = settings;
+  m_settings.cell_size = std::max(m_settings.cell_size, 4);
+  m_settings.region_cells = std::max(m_settings.region_cells, 1);
+  m_settings.fill_chance = std::clamp(m_settings.fill_chance, 0.0f, 1.0f);
+  m_settings.level_jitter = std::clamp(m_settings.level_jitter, 0.0f, 1.0f);
+  if (m_settings.fluids.size() > 254)
+    m_settings.fluids.resize(254);
+  m_seed = seed;
+
+  m_regions = std::make_shared<region_cache_t<region_t>>(256);
+}
+
+auto aquifer_map_t::build_cell(int cell_x, int cell_y) const -> cell_t
+{
+  const float cell = (float)m_settings.cell_size;
+  const float centre_y = ((float)cell_y + 0.5f) * cell;
+  uint32_t h = hash_coords(cell_x, cell_y, m_seed);
+
+  cell_t result;
+  if (hash_to_unit(h) < m_settings.fill_chance)
+  {
+    for (size_t i = 0; i < m_settings.fluids.size(); i++)
+    {
+      if (centre_y <= (float)m_settings.fluids[i].max_y)
+      {
+        result.fluid = (uint8_t)(i + 1);
+        break;
+      }
+    }
+  }
+
+  if (result.fluid)
+  {
+    float jitter = hash_to_unit(hash_u32(h)) - 0.5f;
+    result.level = centre_y + jitter * m_settings.level_jitter * cell;
+  }
+  else
+  {
+    // Dry cells pull the interpolated level down, so pools taper off towards them
+    result.level = (float)cell_y * cell - cell * 0.5f;
+  }
+  return result;
+}
+
+auto aquifer_map_t::build_region(int rx, int ry) const -> region_t
+{
+  const int n = m_settings.region_cells;
+  region_t region;
+  region.cells.reserve(n * n);
+  for (int cy = 0; cy < n; cy++)
+  {
+    for (int cx = 0; cx < n; cx++)
+    {
+      region.cells.push_back(build_cell(rx * n + cx, ry * n + cy));
+    }
+  }
+  return region;
+}
+
+auto aquifer_map_t::get_window(int x0, int y0, int x1, int y1) const -> window_t
+{
+  window_t window;
+  if (!is_enabled())
+    return window;
+
+  const int cell = m_settings.cell_size;
+  const int n = m_settings.region_cells;
+
+  // Interpolation reads the cell centres around each tile, which always include its own cell
+  const int cx0 = (int)std::floor(cell_coord(x0, cell));
+  const int cx1 = (int)std::floor(cell_coord(x1, cell)) + 1;
+  const int cy0 = (int)std::floor(cell_coord(y0, cell));
+  const int cy1 = (int)std::floor(cell_coord(y1, cell)) + 1;
+
+  window.m_cell_size = cell;
+  window.m_cx0 = cx0;
+  window.m_cy0 = cy0;
+  window.m_width = cx1 - cx0 + 1;
+  window.m_cells.reserve(window.m_width * (cy1 - cy0 + 1));
+
+  for (int cy = cy0; cy <= cy1; cy++)
+  {
+    int ry = floor_div(cy, n);
+    for (int cx = cx0; cx <= cx1; cx++)
+    {
+      int rx = floor_div(cx, n);
+      auto region = m_regions->get_or_create(rx, ry, [this](int x, int y) { return build_region(x, y); });
+      window.m_cells.push_back(region->cells[(cy - ry * n) * n + (cx - rx * n)]);
+    }
+  }
+
+  return window;
+}
+
+auto aquifer_map_t::window_t::fluid_at(int x, int y) const -> uint8_t
+{
+  if (m_cells.empty())
+    return 0;
+
+  const auto &own = cell(floor_div(x, m_cell_size), floor_div(y, m_cell_size));
+  if (!own.fluid)
+    return 0;
+
+  float fx = cell_coord(x, m_cell_size);
+  float fy = cell_coord(y, m_cell_size);
+  int ix = (int)std::floor(fx);
+  int iy = (int)std::floor(fy);
+  float tx = fx - (float)ix;
+  float ty = fy - (float)iy;
+
+  float a = cell(ix, iy).level + (cell(ix + 1, iy).level - cell(ix, iy).level) * tx;
+  float b = cell(ix, iy + 1).level + (cell(ix + 1, iy + 1).level - cell(ix, iy + 1).level) * tx;
+  float level = a + (b - a) * ty;
+
+  return ((float)y + 0.5f <= level) ? own.fluid : 0;
+}
+
+} // namespace deepbound
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "core/worldgen/region_cache.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace deepbound
+{
+
+/**
+ * @brief Underground fluid bodies on a coarse grid.
+ *
+ * Every cell (e.g. 16x16 tiles) gets a fluid level and a fluid index, both derived from a hash
+ * of the cell coordinates. Cells are built per region and cached. Carved air is flooded when it
+ * lies inside a cell holding fluid and below the level interpolated between neighbouring cell
+ * centres, so pools have a continuous surface instead of stepping at every cell edge.
+ */
+class aquifer_map_t
+{
+public:
+  struct fluid_t
+  {
+    int max_y = 1 << 30; // Cells centred above this Y can't hold this fluid
+  };
+
+  struct settings_t
+  {
+    bool enabled = false;
+    int cell_size = 16;
+    int region_cells = 16;      // Cells per region edge (cache granularity)
+    float fill_chance = 0.3f;   // Fraction of cells holding fluid
+    float level_jitter = 0.75f; // Level spread inside the cell, as a fraction of the cell height
+    int min_depth = 30;         // Tiles below the surface before caves can flood
+    std::vector<fluid_t> fluids; // First fluid whose range contains the cell wins
+  };
+
+  struct cell_t
+  {
+    float level = 0.0f;
+    uint8_t fluid = 0; // 0 = dry, otherwise index into settings.fluids + 1
+  };
+
+  // The cells covering a box of tiles, resolved once per chunk
+  class window_t
+  {
+  public:
+    // Fluid index + 1 at (x, y) if the tile lies below the local fluid level, otherwise 0
+    auto fluid_at(int x, int y) const -> uint8_t;
+
+  private:
+    friend class aquifer_map_t;
+
+    auto cell(int cx, int cy) const -> const cell_t &
+    {
+      return m_cells[(cy - m_cy0) * m_width + (cx - m_cx0)];
+    }
+
+    int m_cell_size = 16;
+    int m_cx0 = 0;
+    int m_cy0 = 0;
+    int m_width = 0;
+    std::vector<cell_t> m_cells;
+  };
+
+  aquifer_map_t() = default;
+
+  auto configure(const settings_t &settings, int seed) -> void;
+  auto is_enabled() const -> bool
+  {
+    return m_settings.enabled && !m_settings.fluids.empty();
+  }
+  auto get_settings() const -> const settings_t &
+  {
+    return m_settings;
+  }
+
+  // Resolves every cell needed to answer fluid_at() for [x0, x1] x [y0, y1] (inclusive, world tiles)
+  auto get_window(int x0, int y0, int x1, int y1) const -> window_t;
+
+private:
+  struct region_t
+  {
+    std::vector<cell_t> cells; // region_cells * region_cells, row-major by cell y
+  };
+
+  auto build_region(int rx, int ry) const -> region_t;
+  auto build_cell(int cell_x, int cell_y) const -> cell_t;
+
+  settings_t m_settings;
+  int m_seed = 0;
+  std::shared_ptr<region_cache_t<region_t>> m_regions;
+};
+
+} // namespace deepbound
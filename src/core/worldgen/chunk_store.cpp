@@ -0,0 +1,606 @@
+#include "core/worldgen/chunk_store.hpp"
+#include "core/content/item.hpp"
+#include "core/content/tile.hpp"
+#include "core/worldgen/floor_div.hpp"
+#include "core/worldgen/world.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <utility>
+
+namespace deepbound
+{
+
+namespace
+{
+constexpr uint32_t RECORD_MAGIC = 0x31434244; // "DBC1"
+constexpr size_t HEADER_SIZE = 20;           // magic, size, cx, cy, checksum
+constexpr uint32_t MAX_RECORD_SIZE = 4u << 20;
+constexpr uint64_t COMPACT_MIN_BYTES = 1u << 20; // Smaller region files aren't worth rewriting
+constexpr uint8_t FORMAT_VERSION = 2; // 2: liquid layer, no fluid level in tile states
+
+// Chunk within its region
+auto local_index(int cx, int cy) -> uint32_t
+{
+  const int size = chunk_store_t::REGION_SIZE;
+  return (uint32_t)((cx - floor_div(cx, size) * size) * size + (cy - floor_div(cy, size) * size));
+}
+
+auto checksum(const uint8_t *data, size_t size) -> uint32_t
+{
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; i++)
+    hash = (hash ^ data[i]) * 16777619u;
+  return hash;
+}
+
+// Little endian regardless of the host
+struct byte_writer_t
+{
+  std::vector<uint8_t> &out;
+
+  void u8(uint8_t v)
+  {
+    out.push_back(v);
+  }
+  void u16(uint16_t v)
+  {
+    u8((uint8_t)v);
+    u8((uint8_t)(v >> 8));
+  }
+  void u32(uint32_t v)
+  {
+    u16((uint16_t)v);
+    u16((uint16_t)(v >> 16));
+  }
+  void f32(float v)
+  {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    u32(bits);
+  }
+  void str(const std::string &s)
+  {
+    u16((uint16_t)s.size());
+    out.insert(out.end(), s.begin(), s.end());
+  }
+};
+
+// Reads past the end return zeros and clear `ok`
+struct byte_reader_t
+{
+  const uint8_t *data;
+  size_t size;
+  size_t pos = 0;
+  bool ok = true;
+
+  uint8_t u8()
+  {
+    if (pos >= size)
+    {
+      ok = false;
+      return 0;
+    }
+    return data[pos++];
+  }
+  uint16_t u16()
+  {
+    uint16_t lo = u8();
+    return (uint16_t)(lo | (u8() << 8));
+  }
+  uint32_t u32()
+  {
+    uint32_t lo = u16();
+    return lo | ((uint32_t)u16() << 16);
+  }
+  float f32()
+  {
+    uint32_t bits = u32();
+    float v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+  }
+  std::string str()
+  {
+    size_t length = u16();
+    if (pos + length > size)
+    {
+      ok = false;
+      return {};
+    }
+    std::string s((const char *)data + pos, length);
+    pos += length;
+    return s;
+  }
+};
+} // namespace
+
+chunk_store_t::chunk_store_t(std::string directory, size_t bytes_per_second) : m_directory(std::move(directory)), m_io(2, bytes_per_second)
+{
+  std::error_code ec;
+  std::filesystem::create_directories(m_directory, ec);
+  if (ec)
+    std::cerr << "Failed to create save directory " << m_directory << ": " << ec.message() << std::endl;
+}
+
+auto chunk_store_t::write(int cx, int cy, std::vector<uint8_t> data) -> void
+{
+  auto shared = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+  region_t *region;
+  uint64_t serial;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    region = &get_region(floor_div(cx, REGION_SIZE), floor_div(cy, REGION_SIZE));
+    serial = m_next_serial++;
+    region->pending[local_index(cx, cy)] = {shared, serial};
+  }
+  append_record(region, cx, cy, std::move(shared), serial);
+}
+
+auto chunk_store_t::retry(int cx, int cy) -> bool
+{
+  region_t *region;
+  std::shared_ptr<const std::vector<uint8_t>> data;
+  uint64_t serial;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    region = &get_region(floor_div(cx, REGION_SIZE), floor_div(cy, REGION_SIZE));
+    auto it = region->pending.find(local_index(cx, cy));
+    if (it == region->pending.end())
+      return false;
+    serial = it->second.serial = m_next_serial++;
+    data = it->second.data;
+  }
+  append_record(region, cx, cy, std::move(data), serial);
+  return true;
+}
+
+auto chunk_store_t::take_failed() -> std::vector<std::pair<int, int>>
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return std::exchange(m_failed, {});
+}
+
+auto chunk_store_t::append_record(region_t *region, int cx, int cy, std::shared_ptr<const std::vector<uint8_t>> data, uint64_t serial) -> void
+{
+  const uint32_t size = (uint32_t)data->size();
+  const uint32_t sum = checksum(data->data(), data->size());
+  std::vector<uint8_t> record;
+  record.reserve(HEADER_SIZE + data->size());
+  byte_writer_t header{record};
+  header.u32(RECORD_MAGIC);
+  header.u32(size);
+  header.u32((uint32_t)cx);
+  header.u32((uint32_t)cy);
+  header.u32(sum);
+  record.insert(record.end(), data->begin(), data->end());
+
+  // Regions are never removed, so the pointer stays valid until m_io has drained
+  const uint32_t local = local_index(cx, cy);
+  m_io.append(region->path, std::move(record),
+              [this, region, local, cx, cy, serial, size, sum](bool ok, uint64_t offset)
+              {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = region->pending.find(local);
+                const bool newest = it != region->pending.end() && it->second.serial == serial;
+                if (!ok)
+                {
+                  // Still served from memory; the owner decides whether to write it again
+                  if (newest)
+                    m_failed.push_back({cx, cy});
+                  return;
+                }
+                auto &record = region->records[local];
+                if (record.size != 0)
+                  region->live_bytes -= HEADER_SIZE + record.size;
+                record = {offset + HEADER_SIZE, size, sum};
+                region->live_bytes += HEADER_SIZE + size;
+                region->file_bytes = std::max(region->file_bytes, offset + HEADER_SIZE + size);
+                if (newest)
+                  region->pending.erase(it);
+                maybe_compact(*region);
+              });
+}
+
+auto chunk_store_t::read(int cx, int cy, std::vector<uint8_t> &out) -> bool
+{
+  const uint32_t local = local_index(cx, cy);
+  region_t *region;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    region = &get_region(floor_div(cx, REGION_SIZE), floor_div(cy, REGION_SIZE));
+    auto pending = region->pending.find(local);
+    if (pending != region->pending.end())
+    {
+      out = *pending->second.data;
+      return true;
+    }
+    m_indexed.wait(lock, [region]() { return region->indexed; });
+  }
+
+  // Appends never move a record; only compaction does, and it waits for this lock
+  std::shared_lock<std::shared_mutex> file_lock(region->file_mutex);
+  record_t record;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = region->records.find(local);
+    if (it == region->records.end())
+      return false;
+    record = it->second;
+  }
+
+  std::ifstream file(region->path, std::ios::binary);
+  out.resize(record.size);
+  if (!file.seekg((std::streamoff)record.offset) || !file.read((char *)out.data(), record.size) || checksum(out.data(), out.size()) != record.checksum)
+  {
+    std::cerr << "Damaged save record for chunk " << cx << ", " << cy << " in " << region->path << std::endl;
+    return false;
+  }
+  return true;
+}
+
+auto chunk_store_t::flush() -> void
+{
+  m_io.flush();
+}
+
+auto chunk_store_t::get_region(int rx, int ry) -> region_t &
+{
+  uint64_t key = ((uint64_t)(uint32_t)rx << 32) | (uint32_t)ry;
+  auto &region = m_regions[key];
+  if (!region)
+  {
+    region = std::make_unique<region_t>();
+    region->path = m_directory + "/r." + std::to_string(rx) + "." + std::to_string(ry) + ".dbr";
+    // Ahead of any write to the file, so the scan sees exactly what earlier sessions left
+    m_io.run_exclusive(region->path, [this, r = region.get()]() { index_region(*r); });
+  }
+  return *region;
+}
+
+auto chunk_store_t::index_region(region_t &region) -> void
+{
+  std::unordered_map<uint32_t, record_t> records;
+  uint64_t live_bytes = 0;
+  uint64_t file_bytes = 0;
+  std::ifstream file(region.path, std::ios::binary);
+  std::vector<uint8_t> bytes;
+  if (file.is_open()) // Nothing saved here yet otherwise
+    bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  file.close();
+
+  // Record at `pos` if its header and payload check out
+  auto parse = [&](size_t pos, record_t &record, int &cx, int &cy) -> bool
+  {
+    if (bytes.size() - pos < HEADER_SIZE)
+      return false;
+    byte_reader_t in{bytes.data() + pos, HEADER_SIZE};
+    uint32_t magic = in.u32();
+    record.size = in.u32();
+    cx = (int)in.u32();
+    cy = (int)in.u32();
+    record.checksum = in.u32();
+    record.offset = pos + HEADER_SIZE;
+    return magic == RECORD_MAGIC && record.size <= MAX_RECORD_SIZE && bytes.size() - record.offset >= record.size &&
+           checksum(bytes.data() + record.offset, record.size) == record.checksum;
+  };
+
+  size_t pos = 0;
+  size_t end = 0; // Just past the last good record
+  size_t skipped = 0;
+  while (pos < bytes.size())
+  {
+    record_t record;
+    int cx, cy;
+    if (parse(pos, record, cx, cy))
+    {
+      records[local_index(cx, cy)] = record; // Later records replace earlier ones
+      pos = end = record.offset + record.size;
+      continue;
+    }
+
+    // A write that failed partway; records queued after it follow the damage. Resume at the next
+    // magic whose record checks out.
+    size_t next = pos + 1;
+    for (; next + HEADER_SIZE <= bytes.size(); next++)
+    {
+      byte_reader_t in{bytes.data() + next, 4};
+      if (in.u32() == RECORD_MAGIC && parse(next, record, cx, cy))
+        break;
+    }
+    if (next + HEADER_SIZE > bytes.size())
+      break;
+    skipped += next - pos;
+    pos = next;
+  }
+
+  if (skipped > 0)
+    std::cerr << "Skipped " << skipped << " damaged bytes in " << region.path << std::endl;
+
+  // A torn record at the very end. Cut it, or new records appended behind it would have to be
+  // found by the search above on every start.
+  if (bytes.size() > end)
+  {
+    std::cerr << "Dropping " << (bytes.size() - end) << " damaged bytes at the end of " << region.path << std::endl;
+    std::error_code ec;
+    std::filesystem::resize_file(region.path, end, ec);
+  }
+  file_bytes = end;
+  for (const auto &[local, record] : records)
+    live_bytes += HEADER_SIZE + record.size;
+
+  // No write to this file has completed yet (they queue behind this), so nothing is overwritten
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    region.records = std::move(records);
+    region.live_bytes = live_bytes;
+    region.file_bytes = file_bytes;
+    region.indexed = true;
+    maybe_compact(region);
+  }
+  m_indexed.notify_all();
+}
+
+auto chunk_store_t::maybe_compact(region_t &region) -> void
+{
+  if (region.compacting || !region.indexed || region.file_bytes < COMPACT_MIN_BYTES || region.file_bytes < region.live_bytes * 2)
+    return;
+  region.compacting = true;
+  m_io.run_exclusive(region.path, [this, r = &region]() { compact_region(*r); });
+}
+
+auto chunk_store_t::compact_region(region_t &region) -> void
+{
+  // Writes to the file wait for this task, so the records can't change until it returns
+  std::vector<std::pair<uint32_t, record_t>> live;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    live.assign(region.records.begin(), region.records.end());
+  }
+  std::sort(live.begin(), live.end(), [](const auto &a, const auto &b) { return a.second.offset < b.second.offset; });
+
+  std::ifstream file(region.path, std::ios::binary);
+  const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  file.close();
+
+  // Header and payload copied as they are, in file order
+  std::vector<uint8_t> compacted;
+  std::unordered_map<uint32_t, record_t> records;
+  for (const auto &[local, record] : live)
+  {
+    if (record.offset < HEADER_SIZE || record.offset + record.size > bytes.size() || checksum(bytes.data() + record.offset, record.size) != record.checksum)
+      continue; // Damaged since it was indexed; read() would reject it too
+    records[local] = {compacted.size() + HEADER_SIZE, record.size, record.checksum};
+    compacted.insert(compacted.end(), bytes.begin() + (ptrdiff_t)(record.offset - HEADER_SIZE), bytes.begin() + (ptrdiff_t)(record.offset + record.size));
+  }
+
+  const std::string temp_path = region.path + ".tmp";
+  bool ok = async_io_t::write_file(temp_path, compacted);
+  std::error_code ec;
+  {
+    std::unique_lock<std::shared_mutex> file_lock(region.file_mutex);
+    if (ok)
+      std::filesystem::rename(temp_path, region.path, ec);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    region.compacting = false;
+    if (ok && !ec)
+    {
+      region.records = std::move(records);
+      region.file_bytes = region.live_bytes = compacted.size();
+    }
+  }
+
+  if (!ok || ec)
+  {
+    std::cerr << "Failed to compact " << region.path << std::endl;
+    std::filesystem::remove(temp_path, ec);
+  }
+}
+
+auto chunk_store_t::encode(const chunk_t &chunk) -> std::vector<uint8_t>
+{
+  std::vector<uint8_t> data;
+  data.reserve(chunk_t::SIZE * chunk_t::SIZE * 10);
+  byte_writer_t out{data};
+  out.u8(FORMAT_VERSION);
+
+  // Tiles as a palette of ids plus one index per tile
+  std::vector<const tile_definition_t *> palette;
+  std::unordered_map<const tile_definition_t *, uint16_t> palette_index;
+  std::vector<uint16_t> indices(chunk.tiles.size());
+  for (size_t i = 0; i < chunk.tiles.size(); i++)
+  {
+    auto [it, added] = palette_index.try_emplace(chunk.tiles[i], (uint16_t)palette.size());
+    if (added)
+      palette.push_back(chunk.tiles[i]);
+    indices[i] = it->second;
+  }
+  out.u16((uint16_t)palette.size());
+  for (const tile_definition_t *tile : palette)
+    out.str(tile ? tile->id.to_string() : "");
+  for (uint16_t index : indices)
+    out.u16(index);
+
+  for (const auto &climate : chunk.climate)
+  {
+    out.f32(climate.temp);
+    out.f32(climate.rain);
+  }
+
+  // Tile states, then containers (the only block entity with data so far)
+  uint16_t state_count = chunk.metadata ? (uint16_t)chunk.metadata->states.size() : 0;
+  out.u16(state_count);
+  if (chunk.metadata)
+  {
+    chunk.metadata->states.for_each(
+        [&](uint16_t index, const tile_state_t &state)
+        {
+          out.u16(index);
+          out.u8(state.damage);
+          out.u8(state.growth_stage);
+          out.u8(state.flags);
+        });
+  }
+
+  std::vector<std::pair<uint16_t, const container_entity_t *>> containers;
+  if (chunk.metadata)
+  {
+    chunk.metadata->entities.for_each(
+        [&](uint16_t index, const std::unique_ptr<block_entity_t> &entity)
+        {
+          if (auto *container = dynamic_cast<const container_entity_t *>(entity.get()))
+            containers.push_back({index, container});
+        });
+  }
+  out.u16((uint16_t)containers.size());
+  for (const auto &[index, container] : containers)
+  {
+    out.u16(index);
+    out.u16((uint16_t)container->slots.size());
+    for (const auto &slot : container->slots)
+    {
+      out.str(slot.item ? slot.item->id.to_string() : "");
+      out.u32((uint32_t)slot.count);
+    }
+  }
+
+  // Liquids: their own palette of tile ids, then only the cells holding liquid
+  std::vector<uint16_t> liquid_palette;
+  std::vector<std::pair<uint16_t, liquid_cell_t>> liquids;
+  chunk.liquids.for_each(
+      [&](int x, int y, const liquid_cell_t &cell)
+      {
+        liquids.push_back({(uint16_t)(x * chunk_t::SIZE + y), cell});
+        if (std::find(liquid_palette.begin(), liquid_palette.end(), cell.type) == liquid_palette.end())
+          liquid_palette.push_back(cell.type);
+      });
+  out.u8((uint8_t)liquid_palette.size());
+  for (uint16_t type : liquid_palette)
+  {
+    const tile_definition_t *tile = tile_registry_t::get().get_tile_by_runtime_id(type);
+    out.str(tile ? tile->id.to_string() : "");
+  }
+  out.u16((uint16_t)liquids.size());
+  for (const auto &[index, cell] : liquids)
+  {
+    out.u16(index);
+    out.u8((uint8_t)(std::find(liquid_palette.begin(), liquid_palette.end(), cell.type) - liquid_palette.begin()));
+    out.u8(cell.level);
+  }
+  return data;
+}
+
+auto chunk_store_t::decode(const std::vector<uint8_t> &data, chunk_t &chunk) -> bool
+{
+  byte_reader_t in{data.data(), data.size()};
+  const uint8_t version = in.u8();
+  if (version == 0 || version > FORMAT_VERSION)
+  {
+    std::cerr << "Unknown chunk save format" << std::endl;
+    return false;
+  }
+
+  // Parsed into locals first, the chunk is only touched once everything read cleanly
+  const auto &tile_registry = tile_registry_t::get();
+  std::vector<const tile_definition_t *> palette(in.u16());
+  for (auto &tile : palette)
+  {
+    std::string id = in.str();
+    tile = id.empty() ? nullptr : tile_registry.get_tile(resource_id_t(id));
+  }
+
+  std::vector<const tile_definition_t *> tiles(chunk_t::SIZE * chunk_t::SIZE);
+  for (auto &tile : tiles)
+  {
+    uint16_t index = in.u16();
+    tile = index < palette.size() ? palette[index] : nullptr;
+  }
+
+  std::vector<climate_info_t> climate(chunk_t::SIZE * chunk_t::SIZE);
+  for (auto &c : climate)
+  {
+    c.temp = in.f32();
+    c.rain = in.f32();
+  }
+
+  auto metadata = std::make_unique<chunk_metadata_t>();
+  for (int count = in.u16(); count > 0 && in.ok; count--)
+  {
+    uint16_t index = in.u16();
+    tile_state_t state;
+    state.damage = in.u8();
+    if (version == 1)
+      in.u8(); // Fluid level, superseded by the liquid layer
+    state.growth_stage = in.u8();
+    state.flags = in.u8();
+    if (index < tiles.size() && !state.is_default())
+      metadata->states.get_or_insert(index) = state;
+  }
+
+  const auto &item_registry = item_registry_t::get();
+  for (int count = in.u16(); count > 0 && in.ok; count--)
+  {
+    uint16_t index = in.u16();
+    auto container = std::make_unique<container_entity_t>(in.u16());
+    for (auto &slot : container->slots)
+    {
+      std::string id = in.str();
+      slot.count = (int)in.u32();
+      slot.item = id.empty() ? nullptr : item_registry.get_item(resource_id_t(id));
+      if (!slot.item)
+        slot.count = 0;
+    }
+    if (index < tiles.size())
+      metadata->entities.get_or_insert(index) = std::move(container);
+  }
+
+  // Version 1 had no liquid layer: water and other liquids were stored as tiles
+  liquid_layer_t liquids;
+  if (version == 1)
+  {
+    for (size_t i = 0; i < tiles.size(); i++)
+    {
+      if (tiles[i] && tiles[i]->draw_type == "liquid")
+      {
+        liquids.set((int)(i / chunk_t::SIZE), (int)(i % chunk_t::SIZE), {tiles[i]->runtime_id, 255});
+        tiles[i] = nullptr;
+      }
+    }
+  }
+  else
+  {
+    std::vector<uint16_t> liquid_palette(in.u8());
+    for (auto &type : liquid_palette)
+    {
+      std::string id = in.str();
+      const tile_definition_t *tile = id.empty() ? nullptr : tile_registry.get_tile(resource_id_t(id));
+      type = tile ? tile->runtime_id : 0;
+    }
+    for (int count = in.u16(); count > 0 && in.ok; count--)
+    {
+      uint16_t index = in.u16();
+      uint8_t type = in.u8();
+      uint8_t level = in.u8();
+      if (index < tiles.size() && type < liquid_palette.size())
+        liquids.set(index / chunk_t::SIZE, index % chunk_t::SIZE, {liquid_palette[type], level});
+    }
+  }
+
+  if (!in.ok)
+  {
+    std::cerr << "Truncated chunk save data" << std::endl;
+    return false;
+  }
+
+  chunk.tiles = std::move(tiles);
+  chunk.climate = std::move(climate);
+  chunk.metadata = metadata->empty() ? nullptr : std::move(metadata);
+  chunk.liquids = std::move(liquids);
+  chunk.mesh_dirty = true;
+  return true;
+}
+
+} // namespace deepbound
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "core/common/async_io.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace deepbound
+{
+
+struct chunk_t;
+
+/**
+ * @brief Saved chunks on disk, one append-only log per region of REGION_SIZE x REGION_SIZE chunks.
+ *
+ * A save appends a record (header + encoded chunk) to the region file through the I/O threads; the
+ * newest record of a chunk wins. A region is indexed on first use by scanning its records on an I/O
+ * thread, ahead of any write to it: write() never waits for that, read() does. Damaged bytes in the
+ * middle (a write that failed partway, with later records behind it) are skipped by searching for
+ * the next valid record; a torn record at the end is cut off. Until a save is on disk, read()
+ * serves it from memory, so a chunk unloaded and requested again right away comes back as saved.
+ * Failed writes are reported through take_failed().
+ * Thread safe: generation tasks read while the main thread queues saves.
+ *
+ * Once superseded records make up most of a region file it is compacted: rewritten on an I/O
+ * thread with only the newest record of each chunk.
+ */
+class chunk_store_t
+{
+public:
+  static constexpr int REGION_SIZE = 32;
+
+  // `directory` is created if needed
+  explicit chunk_store_t(std::string directory, size_t bytes_per_second = 16ull * 1024 * 1024);
+
+  // Queues the encoded chunk for writing
+  auto write(int cx, int cy, std::vector<uint8_t> data) -> void;
+
+  // Newest saved data of the chunk, false if it was never saved (or the record is damaged)
+  auto read(int cx, int cy, std::vector<uint8_t> &out) -> bool;
+
+  // Blocks until every queued save is on disk (or failed)
+  auto flush() -> void;
+
+  // Chunks whose newest save failed to write since the last call. Their data is still served from
+  // memory; retry() queues that copy again, false if a newer save replaced it or there is none.
+  auto take_failed() -> std::vector<std::pair<int, int>>;
+  auto retry(int cx, int cy) -> bool;
+
+  auto get_directory() const -> const std::string &
+  {
+    return m_directory;
+  }
+  auto get_io_stats() const -> async_io_t::stats_t
+  {
+    return m_io.get_stats();
+  }
+
+  // Chunk contents (tiles, climate, tile states, containers) <-> bytes. Tiles and items are stored
+  // by resource id, so saves survive registry changes; unknown ids load as air / empty slots.
+  static auto encode(const chunk_t &chunk) -> std::vector<uint8_t>;
+  static auto decode(const std::vector<uint8_t> &data, chunk_t &chunk) -> bool;
+
+private:
+  struct record_t
+  {
+    uint64_t offset = 0; // Of the payload
+    uint32_t size = 0;
+    uint32_t checksum = 0;
+  };
+
+  struct region_t
+  {
+    std::string path;
+    std::unordered_map<uint32_t, record_t> records; // By chunk index inside the region
+    // Queued, not on disk yet. The serial tells a completed write from a newer one of the same chunk.
+    struct pending_t
+    {
+      std::shared_ptr<const std::vector<uint8_t>> data;
+      uint64_t serial = 0;
+    };
+    std::unordered_map<uint32_t, pending_t> pending;
+
+    bool indexed = false;    // records hold what was on disk before this session, see index_region
+    bool compacting = false; // A compaction is queued
+    uint64_t file_bytes = 0; // Known size of the file
+    uint64_t live_bytes = 0; // Of that, the newest record of each chunk (headers included)
+    // Held shared while reading records, exclusively while compaction swaps the file and offsets
+    std::shared_mutex file_mutex;
+  };
+
+  // Creates the region on first use and queues its indexing. Call with m_mutex held.
+  auto get_region(int rx, int ry) -> region_t &;
+  // Queues header + data for the region file; `serial` must be the chunk's pending serial
+  auto append_record(region_t *region, int cx, int cy, std::shared_ptr<const std::vector<uint8_t>> data, uint64_t serial) -> void;
+  // Both run as exclusive tasks on the region file (async_io_t::run_exclusive)
+  auto index_region(region_t &region) -> void;
+  auto compact_region(region_t &region) -> void;
+  // Queues a compaction if enough of the file is superseded. Call with m_mutex held.
+  auto maybe_compact(region_t &region) -> void;
+
+  std::string m_directory;
+  std::mutex m_mutex;
+  std::condition_variable m_indexed; // A region finished indexing
+  std::unordered_map<uint64_t, std::unique_ptr<region_t>> m_regions;
+  uint64_t m_next_serial = 1;
+  std::vector<std::pair<int, int>> m_failed;
+
+  // Last, so it drains (and runs completions touching the regions) before they are destroyed
+  async_io_t m_io;
+};
+
+} // namespace deepbound
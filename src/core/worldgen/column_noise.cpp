@@ -0,0 +1,230 @@
+#include "core/worldgen/column_noise.hpp"
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define DEEPBOUND_COLUMN_NOISE_X86 1
+#endif
+
+namespace deepbound
+{
+
+namespace
+{
+// Parameters shared by every kernel
+struct fbm_params_t
+{
+  float frequency;
+  float lacunarity;
+  float gain;
+  float bounding;
+  int octaves;
+};
+
+constexpr float GRAD_SCALE = 2.0f / 65535.0f;
+constexpr float NOISE_SCALE = 2.5f; // Roughly matches the spread of the 2D simplex it replaces
+
+// --- Scalar reference ------------------------------------------------------
+// The SIMD kernels below mirror these operations one for one.
+
+inline auto hash_lattice(int32_t i, int32_t seed) -> uint32_t
+{
+  uint32_t h = ((uint32_t)i * 0x9e3779b1u) ^ ((uint32_t)seed * 0x85ebca77u);
+  h ^= h >> 15;
+  h *= 0x2c1b3c6du;
+  h ^= h >> 12;
+  h *= 0x297a2d39u;
+  h ^= h >> 15;
+  return h;
+}
+
+inline auto gradient(int32_t i, int32_t seed) -> float
+{
+  return (float)(int32_t)(hash_lattice(i, seed) & 0xffffu) * GRAD_SCALE - 1.0f;
+}
+
+inline auto noise_scalar(float x, int32_t seed) -> float
+{
+  int32_t xi = (int32_t)x;
+  if ((float)xi > x)
+    xi -= 1;
+  float f = x - (float)xi;
+
+  float v0 = gradient(xi, seed) * f;
+  float v1 = gradient(xi + 1, seed) * (f - 1.0f);
+  float t = f * f * f * (f * (f * 6.0f - 15.0f) + 10.0f);
+  return (v0 + (v1 - v0) * t) * NOISE_SCALE;
+}
+
+inline auto fbm_scalar(int32_t column, int32_t seed, const fbm_params_t &p) -> float
+{
+  float x = (float)column * p.frequency;
+  float amp = 1.0f;
+  float sum = 0.0f;
+  for (int o = 0; o < p.octaves; o++)
+  {
+    sum = sum + noise_scalar(x, seed + o) * amp;
+    x = x * p.lacunarity;
+    amp = amp * p.gain;
+  }
+  return sum * p.bounding;
+}
+
+#if defined(DEEPBOUND_COLUMN_NOISE_X86)
+// --- SSE2 (baseline on x86-64) ---------------------------------------------
+
+inline auto mullo_sse2(__m128i a, __m128i b) -> __m128i
+{
+  // No _mm_mullo_epi32 before SSE4.1: multiply even and odd lanes separately
+  __m128i even = _mm_mul_epu32(a, b);
+  __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+inline auto gradient_sse2(__m128i i, __m128i seed_term) -> __m128
+{
+  __m128i h = _mm_xor_si128(mullo_sse2(i, _mm_set1_epi32((int)0x9e3779b1u)), seed_term);
+  h = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+  h = mullo_sse2(h, _mm_set1_epi32(0x2c1b3c6d));
+  h = _mm_xor_si128(h, _mm_srli_epi32(h, 12));
+  h = mullo_sse2(h, _mm_set1_epi32(0x297a2d39));
+  h = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+  __m128 g = _mm_cvtepi32_ps(_mm_and_si128(h, _mm_set1_epi32(0xffff)));
+  return _mm_sub_ps(_mm_mul_ps(g, _mm_set1_ps(GRAD_SCALE)), _mm_set1_ps(1.0f));
+}
+
+inline auto noise_sse2(__m128 x, int32_t seed) -> __m128
+{
+  const __m128 one = _mm_set1_ps(1.0f);
+  __m128i xi = _mm_cvttps_epi32(x);
+  __m128i adjust = _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(xi), x)); // -1 where truncation rounded up
+  xi = _mm_add_epi32(xi, adjust);
+  __m128 f = _mm_sub_ps(x, _mm_cvtepi32_ps(xi));
+
+  __m128i seed_term = _mm_set1_epi32((int)((uint32_t)seed * 0x85ebca77u));
+  __m128 v0 = _mm_mul_ps(gradient_sse2(xi, seed_term), f);
+  __m128 v1 = _mm_mul_ps(gradient_sse2(_mm_add_epi32(xi, _mm_set1_epi32(1)), seed_term), _mm_sub_ps(f, one));
+
+  __m128 inner = _mm_add_ps(_mm_mul_ps(f, _mm_sub_ps(_mm_mul_ps(f, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))), _mm_set1_ps(10.0f));
+  __m128 t = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(f, f), f), inner);
+  return _mm_mul_ps(_mm_add_ps(v0, _mm_mul_ps(_mm_sub_ps(v1, v0), t)), _mm_set1_ps(NOISE_SCALE));
+}
+
+auto generate_sse2(int x_start, int count, int step, int32_t seed, const fbm_params_t &p, float *out) -> int
+{
+  const __m128i lane_offsets = _mm_setr_epi32(0, step, 2 * step, 3 * step);
+  int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128i column = _mm_add_epi32(_mm_set1_epi32(x_start + i * step), lane_offsets);
+    __m128 x = _mm_mul_ps(_mm_cvtepi32_ps(column), _mm_set1_ps(p.frequency));
+    __m128 amp = _mm_set1_ps(1.0f);
+    __m128 sum = _mm_setzero_ps();
+    for (int o = 0; o < p.octaves; o++)
+    {
+      sum = _mm_add_ps(sum, _mm_mul_ps(noise_sse2(x, seed + o), amp));
+      x = _mm_mul_ps(x, _mm_set1_ps(p.lacunarity));
+      amp = _mm_mul_ps(amp, _mm_set1_ps(p.gain));
+    }
+    _mm_storeu_ps(out + i, _mm_mul_ps(sum, _mm_set1_ps(p.bounding)));
+  }
+  return i;
+}
+
+// --- AVX2 (runtime dispatched) ---------------------------------------------
+
+__attribute__((target("avx2"))) inline auto gradient_avx2(__m256i i, __m256i seed_term) -> __m256
+{
+  __m256i h = _mm256_xor_si256(_mm256_mullo_epi32(i, _mm256_set1_epi32((int)0x9e3779b1u)), seed_term);
+  h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+  h = _mm256_mullo_epi32(h, _mm256_set1_epi32(0x2c1b3c6d));
+  h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 12));
+  h = _mm256_mullo_epi32(h, _mm256_set1_epi32(0x297a2d39));
+  h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+  __m256 g = _mm256_cvtepi32_ps(_mm256_and_si256(h, _mm256_set1_epi32(0xffff)));
+  return _mm256_sub_ps(_mm256_mul_ps(g, _mm256_set1_ps(GRAD_SCALE)), _mm256_set1_ps(1.0f));
+}
+
+__attribute__((target("avx2"))) inline auto noise_avx2(__m256 x, int32_t seed) -> __m256
+{
+  const __m256 one = _mm256_set1_ps(1.0f);
+  __m256i xi = _mm256_cvttps_epi32(x);
+  __m256i adjust = _mm256_castps_si256(_mm256_cmp_ps(_mm256_cvtepi32_ps(xi), x, _CMP_GT_OQ));
+  xi = _mm256_add_epi32(xi, adjust);
+  __m256 f = _mm256_sub_ps(x, _mm256_cvtepi32_ps(xi));
+
+  __m256i seed_term = _mm256_set1_epi32((int)((uint32_t)seed * 0x85ebca77u));
+  __m256 v0 = _mm256_mul_ps(gradient_avx2(xi, seed_term), f);
+  __m256 v1 = _mm256_mul_ps(gradient_avx2(_mm256_add_epi32(xi, _mm256_set1_epi32(1)), seed_term), _mm256_sub_ps(f, one));
+
+  __m256 inner = _mm256_add_ps(_mm256_mul_ps(f, _mm256_sub_ps(_mm256_mul_ps(f, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f))), _mm256_set1_ps(10.0f));
+  __m256 t = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(f, f), f), inner);
+  return _mm256_mul_ps(_mm256_add_ps(v0, _mm256_mul_ps(_mm256_sub_ps(v1, v0), t)), _mm256_set1_ps(NOISE_SCALE));
+}
+
+__attribute__((target("avx2"))) auto generate_avx2(int x_start, int count, int step, int32_t seed, const fbm_params_t &p, float *out) -> int
+{
+  const __m256i lane_offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(step));
+  int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i column = _mm256_add_epi32(_mm256_set1_epi32(x_start + i * step), lane_offsets);
+    __m256 x = _mm256_mul_ps(_mm256_cvtepi32_ps(column), _mm256_set1_ps(p.frequency));
+    __m256 amp = _mm256_set1_ps(1.0f);
+    __m256 sum = _mm256_setzero_ps();
+    for (int o = 0; o < p.octaves; o++)
+    {
+      sum = _mm256_add_ps(sum, _mm256_mul_ps(noise_avx2(x, seed + o), amp));
+      x = _mm256_mul_ps(x, _mm256_set1_ps(p.lacunarity));
+      amp = _mm256_mul_ps(amp, _mm256_set1_ps(p.gain));
+    }
+    _mm256_storeu_ps(out + i, _mm256_mul_ps(sum, _mm256_set1_ps(p.bounding)));
+  }
+  return i;
+}
+
+auto cpu_has_avx2() -> bool
+{
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+#endif
+} // namespace
+
+column_noise_t::column_noise_t(const settings_t &settings) : m_settings(settings), m_configured(true)
+{
+  m_settings.octaves = std::clamp(m_settings.octaves, 1, 16);
+
+  float amp = 1.0f;
+  float total = 0.0f;
+  for (int o = 0; o < m_settings.octaves; o++)
+  {
+    total += amp;
+    amp *= m_settings.gain;
+  }
+  m_bounding = (total > 0.0f) ? 1.0f / total : 1.0f;
+}
+
+auto column_noise_t::generate(int x_start, int count, int step, int seed, float *out) const -> void
+{
+  const fbm_params_t params = {m_settings.frequency, m_settings.lacunarity, m_settings.gain, m_bounding, m_settings.octaves};
+
+  int done = 0;
+#if defined(DEEPBOUND_COLUMN_NOISE_X86)
+  if (cpu_has_avx2())
+    done = generate_avx2(x_start, count, step, seed, params, out);
+  done += generate_sse2(x_start + done * step, count - done, step, seed, params, out + done);
+#endif
+
+  for (int i = done; i < count; i++)
+    out[i] = fbm_scalar(x_start + i * step, seed, params);
+}
+
+auto column_noise_t::single(int x, int seed) const -> float
+{
+  const fbm_params_t params = {m_settings.frequency, m_settings.lacunarity, m_settings.gain, m_bounding, m_settings.octaves};
+  return fbm_scalar(x, seed, params);
+}
+
+} // namespace deepbound
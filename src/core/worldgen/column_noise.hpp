@@ -0,0 +1,43 @@
+#pragma once
+
+namespace deepbound
+{
+
+/**
+ * @brief 1D gradient noise + FBm for per-column signals (continental, climate, landforms).
+ *
+ * These signals only vary along X, so sampling 2D noise at y = 0 wastes half the work.
+ * generate() evaluates a whole row at once, 8 or 4 columns per step with AVX2 or SSE2 picked at
+ * runtime. Every path performs the same float operations in the same order (the file is built
+ * without FP contraction), so results are bit-identical on any CPU.
+ */
+class column_noise_t
+{
+public:
+  struct settings_t
+  {
+    float frequency = 0.01f;
+    int octaves = 3;
+    float lacunarity = 2.0f;
+    float gain = 0.5f;
+  };
+
+  column_noise_t() = default;
+  explicit column_noise_t(const settings_t &settings);
+
+  auto is_configured() const -> bool
+  {
+    return m_configured;
+  }
+
+  // out[i] = noise at column x_start + i * step, roughly in [-1, 1]
+  auto generate(int x_start, int count, int step, int seed, float *out) const -> void;
+  auto single(int x, int seed) const -> float;
+
+private:
+  settings_t m_settings;
+  float m_bounding = 1.0f; // Normalises the octave sum back to [-1, 1]
+  bool m_configured = false;
+};
+
+} // namespace deepbound
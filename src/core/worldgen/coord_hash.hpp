@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+namespace deepbound
+{
+
+// Stateless integer hashes for deterministic worldgen decisions (cell jitter, object placement).
+// Results depend only on the inputs, never on evaluation order or thread.
+
+inline auto hash_u32(uint32_t h) -> uint32_t
+{
+  h ^= h >> 16;
+  h *= 0x7feb352du;
+  h ^= h >> 15;
+  h *= 0x846ca68bu;
+  h ^= h >> 16;
+  return h;
+}
+
+inline auto hash_coords(int x, int y, int seed) -> uint32_t
+{
+  uint32_t h = (uint32_t)seed * 0x9e3779b9u;
+  h = hash_u32(h ^ (uint32_t)x * 0x85ebca6bu);
+  h = hash_u32(h ^ (uint32_t)y * 0xc2b2ae35u);
+  return h;
+}
+
+// Maps a hash to [0, 1)
+inline auto hash_to_unit(uint32_t h) -> float
+{
+  return (float)(h >> 8) * (1.0f / 16777216.0f);
+}
+
+} // namespace deepbound
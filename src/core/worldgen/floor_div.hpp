@@ -0,0 +1,16 @@
+#pragma once
+
+namespace deepbound
+{
+
+// Integer division rounding toward negative infinity, for mapping tile coordinates to chunks,
+// regions and cells (plain `/` is off by one for negative coordinates)
+inline auto floor_div(int a, int b) -> int
+{
+  int q = a / b;
+  if ((a % b != 0) && ((a < 0) != (b < 0)))
+    q--;
+  return q;
+}
+
+} // namespace deepbound
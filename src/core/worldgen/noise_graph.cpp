@@ -0,0 +1,210 @@
+#include "core/worldgen/noise_graph.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+
+namespace deepbound
+{
+
+namespace
+{
+// "Domain Scale", "domainscale" and "DomainScale" all compare equal
+auto normalize_name(const std::string &name) -> std::string
+{
+  std::string out;
+  out.reserve(name.size());
+  for (char c : name)
+  {
+    if (!std::isspace((unsigned char)c) && c != '_' && c != '-')
+      out.push_back((char)std::tolower((unsigned char)c));
+  }
+  return out;
+}
+
+auto find_metadata(const std::string &name) -> const FastNoise::Metadata *
+{
+  const std::string wanted = normalize_name(name);
+  for (const FastNoise::Metadata *meta : FastNoise::Metadata::GetAll())
+  {
+    if (normalize_name(meta->name) == wanted || normalize_name(FastNoise::Metadata::FormatMetadataNodeName(meta, true)) == wanted)
+      return meta;
+  }
+  return nullptr;
+}
+
+template <typename T>
+auto member_matches(const T &member, const std::string &key) -> bool
+{
+  const std::string wanted = normalize_name(key);
+  return normalize_name(member.name) == wanted || normalize_name(FastNoise::Metadata::FormatMetadataMemberName(member)) == wanted;
+}
+} // namespace
+
+auto noise_graph_t::compile(const nlohmann::json &j, std::string &error) -> bool
+{
+  m_nodes.clear();
+  if (compile_node(j, 0, error) < 0)
+  {
+    m_nodes.clear();
+    return false;
+  }
+  return true;
+}
+
+auto noise_graph_t::assign(FastNoise::SmartNode<> node, const std::string &name) -> void
+{
+  m_nodes.clear();
+  m_nodes.push_back({name, 0, node, {}});
+}
+
+auto noise_graph_t::compile_node(const nlohmann::json &j, int depth, std::string &error) -> int
+{
+  // Encoded tree: opaque, one entry
+  if (j.is_string() || (j.is_object() && j.contains("encoded")))
+  {
+    std::string encoded = j.is_string() ? j.get<std::string>() : j["encoded"].get<std::string>();
+    auto node = FastNoise::NewFromEncodedNodeTree(encoded.c_str());
+    if (!node)
+    {
+      error = "invalid encoded node tree";
+      return -1;
+    }
+    m_nodes.push_back({"Encoded", depth, node, {}});
+    return (int)m_nodes.size() - 1;
+  }
+
+  if (!j.is_object() || !j.contains("node") || !j["node"].is_string())
+  {
+    error = "expected an encoded string or an object with a \"node\" name";
+    return -1;
+  }
+
+  const std::string type = j["node"].get<std::string>();
+  const FastNoise::Metadata *meta = find_metadata(type);
+  if (!meta)
+  {
+    error = "unknown node type '" + type + "'";
+    return -1;
+  }
+
+  const int index = (int)m_nodes.size();
+  m_nodes.push_back({meta->name, depth, meta->CreateNode(), {}});
+  FastNoise::Generator *generator = m_nodes[index].node.get();
+
+  for (const auto &[key, value] : j.items())
+  {
+    if (key == "node")
+      continue;
+
+    bool handled = false;
+
+    for (const auto &var : meta->memberVariables)
+    {
+      if (!member_matches(var, key))
+        continue;
+
+      FastNoise::Metadata::MemberValue v = var.valueDefault;
+      if (var.type == FastNoise::Metadata::MemberVariable::EFloat && value.is_number())
+        v.f = value.get<float>();
+      else if (var.type == FastNoise::Metadata::MemberVariable::EInt && value.is_number_integer())
+        v.i = value.get<int>();
+      else if (var.type == FastNoise::Metadata::MemberVariable::EEnum && value.is_number_integer())
+        v.i = value.get<int>();
+      else if (var.type == FastNoise::Metadata::MemberVariable::EEnum && value.is_string())
+      {
+        auto it = std::find_if(var.enumNames.begin(), var.enumNames.end(), [&](const char *e) { return normalize_name(e) == normalize_name(value.get<std::string>()); });
+        if (it == var.enumNames.end())
+        {
+          error = type + "." + key + ": unknown value '" + value.get<std::string>() + "'";
+          return -1;
+        }
+        v.i = (int)(it - var.enumNames.begin());
+      }
+      else
+      {
+        error = type + "." + key + ": wrong value type";
+        return -1;
+      }
+
+      var.setFunc(generator, v);
+      handled = true;
+      break;
+    }
+
+    for (size_t l = 0; !handled && l < meta->memberNodeLookups.size(); l++)
+    {
+      const auto &lookup = meta->memberNodeLookups[l];
+      if (!member_matches(lookup, key))
+        continue;
+
+      int child = compile_node(value, depth + 1, error);
+      if (child < 0)
+        return -1;
+      lookup.setFunc(generator, m_nodes[child].node);
+      m_nodes[index].children.push_back(child);
+      handled = true;
+    }
+
+    for (size_t h = 0; !handled && h < meta->memberHybrids.size(); h++)
+    {
+      const auto &hybrid = meta->memberHybrids[h];
+      if (!member_matches(hybrid, key))
+        continue;
+
+      if (value.is_number())
+      {
+        hybrid.setValueFunc(generator, value.get<float>());
+      }
+      else
+      {
+        int child = compile_node(value, depth + 1, error);
+        if (child < 0)
+          return -1;
+        hybrid.setNodeFunc(generator, m_nodes[child].node);
+        m_nodes[index].children.push_back(child);
+      }
+      handled = true;
+    }
+
+    if (!handled)
+    {
+      error = type + ": unknown member '" + key + "'";
+      return -1;
+    }
+  }
+
+  return index;
+}
+
+auto noise_graph_t::profile(int grid_size, int repeats) const -> std::vector<profile_entry_t>
+{
+  std::vector<profile_entry_t> entries(m_nodes.size());
+  std::vector<float> buffer((size_t)grid_size * grid_size);
+  const double samples = (double)grid_size * grid_size * repeats;
+
+  for (size_t i = 0; i < m_nodes.size(); i++)
+  {
+    const auto &n = m_nodes[i];
+    n.node->GenUniformGrid2D(buffer.data(), 0, 0, grid_size, grid_size, 0.05f, 1337); // Warm up
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+      n.node->GenUniformGrid2D(buffer.data(), r * grid_size, 0, grid_size, grid_size, 0.05f, 1337);
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    entries[i] = {n.name, n.depth, ns / samples, 0.0};
+  }
+
+  // Exclusive cost: a node's subtree time minus its direct children's subtree times
+  for (size_t i = 0; i < m_nodes.size(); i++)
+  {
+    double self = entries[i].total_ns;
+    for (int child : m_nodes[i].children)
+      self -= entries[child].total_ns;
+    entries[i].self_ns = std::max(0.0, self);
+  }
+
+  return entries;
+}
+
+} // namespace deepbound
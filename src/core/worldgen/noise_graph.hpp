@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <FastNoise/FastNoise.h>
+#include <nlohmann/json.hpp>
+
+namespace deepbound
+{
+
+/**
+ * @brief FastNoise2 node tree described in worldgen JSON, compiled once at load.
+ *
+ * Accepts either an encoded node tree (as exported by the FastNoise2 NoiseTool):
+ *   "graph": "DQAFAAAAAAAAQAgAAAAAAD8AAAAAAA=="
+ * or a readable node description, matched against FastNoise2's metadata by name:
+ *   "graph": { "node": "DomainScale", "Scale": 0.02,
+ *              "Source": { "node": "FractalFBm", "Octaves": 2, "Source": { "node": "Simplex" } } }
+ * Node and member names ignore case and spaces. Hybrid members take a number or a child node.
+ *
+ * Every node of a description is kept, so profile() can time each subtree and report the
+ * cost of each node on its own. Encoded trees profile as a single node.
+ */
+class noise_graph_t
+{
+public:
+  struct profile_entry_t
+  {
+    std::string name;
+    int depth;
+    double total_ns; // Per sample, including children
+    double self_ns;  // Per sample, this node only
+  };
+
+  noise_graph_t() = default;
+
+  // Returns false and fills `error` if the description can't be compiled
+  auto compile(const nlohmann::json &j, std::string &error) -> bool;
+  // Wraps a node built in code so it can be profiled next to compiled graphs
+  auto assign(FastNoise::SmartNode<> node, const std::string &name) -> void;
+
+  auto empty() const -> bool
+  {
+    return m_nodes.empty();
+  }
+  auto get_root() const -> FastNoise::SmartNode<>
+  {
+    return m_nodes.empty() ? FastNoise::SmartNode<>() : m_nodes[0].node;
+  }
+
+  // Times every node on a grid_size x grid_size reference grid, root first
+  auto profile(int grid_size = 128, int repeats = 8) const -> std::vector<profile_entry_t>;
+
+private:
+  struct node_t
+  {
+    std::string name;
+    int depth = 0;
+    FastNoise::SmartNode<> node;
+    std::vector<int> children;
+  };
+
+  auto compile_node(const nlohmann::json &j, int depth, std::string &error) -> int;
+
+  std::vector<node_t> m_nodes;
+};
+
+} // namespace deepbound
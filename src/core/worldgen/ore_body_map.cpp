@@ -0,0 +1,243 @@
+#include "core/worldgen/ore_body_map.hpp"
+#include "core/worldgen/coord_hash.hpp"
+#include "core/worldgen/floor_div.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace deepbound
+{
+
+namespace
+{
+constexpr float VEIN_STEP = 3.0f; // Tiles per vein walk step
+} // namespace
+
+auto ore_body_map_t::configure(const settings_t &settings, int seed) -> void
+{
+  m_settings = settings;
+  m_settings.region_size = std::max(m_settings.region_size, 32);
+  if (m_settings.ores.size() > 254)
+    m_settings.ores.resize(254);
+  m_seed = seed;
+
+  // Bodies are anchored inside their region but can reach past it
+  m_max_extent = 0;
+  for (auto &ore : m_settings.ores)
+  {
+    ore.spacing = std::clamp(ore.spacing, 4.0f, (float)m_settings.region_size * 0.5f);
+    ore.max_size = std::max(ore.max_size, ore.min_size);
+    ore.max_thickness = std::max(ore.max_thickness, ore.min_thickness);
+
+    float reach = (ore.shape == ore_shape_e::vein) ? (float)ore.max_size * VEIN_STEP + ore.max_thickness : (float)ore.max_size * 2.0f;
+    m_max_extent = std::max(m_max_extent, (int)std::ceil(reach) + 1);
+  }
+
+  m_regions = std::make_shared<region_cache_t<region_t>>(256);
+}
+
+auto ore_body_map_t::build_body(int ore_idx, float x, float y, uint32_t hash) const -> body_t
+{
+  const auto &ore = m_settings.ores[ore_idx];
+  auto next = [&hash]() { return hash_to_unit(hash = hash_u32(hash)); };
+
+  body_t body;
+  body.ore = ore_idx;
+  int size = ore.min_size + (int)(next() * (float)(ore.max_size - ore.min_size + 1));
+  size = std::min(size, ore.max_size);
+
+  if (ore.shape == ore_shape_e::vein)
+  {
+    float thickness = ore.min_thickness + next() * (ore.max_thickness - ore.min_thickness);
+    float angle = next() * 6.2831853f;
+    float px = x, py = y;
+    for (int s = 0; s < size; s++)
+    {
+      // Drift the heading a little each step, thinning towards the ends
+      angle += (next() - 0.5f) * 1.2f;
+      float nx = px + std::cos(angle) * VEIN_STEP;
+      float ny = py + std::sin(angle) * VEIN_STEP;
+      float taper = 1.0f - std::abs((float)s / (float)std::max(size - 1, 1) - 0.5f);
+      body.parts.push_back({px, py, nx, ny, std::max(0.5f, thickness * taper)});
+      px = nx;
+      py = ny;
+    }
+  }
+  else
+  {
+    // Main disc plus a few satellites so blobs aren't perfect circles
+    float radius = (float)size;
+    body.parts.push_back({x, y, x, y, radius});
+    int satellites = 2 + (int)(next() * 3.0f);
+    for (int s = 0; s < satellites; s++)
+    {
+      float a = next() * 6.2831853f;
+      float d = radius * (0.4f + next() * 0.6f);
+      float sx = x + std::cos(a) * d;
+      float sy = y + std::sin(a) * d;
+      body.parts.push_back({sx, sy, sx, sy, radius * (0.4f + next() * 0.5f)});
+    }
+  }
+
+  float min_x = x, min_y = y, max_x = x, max_y = y;
+  for (const auto &p : body.parts)
+  {
+    min_x = std::min({min_x, p.x0 - p.radius, p.x1 - p.radius});
+    min_y = std::min({min_y, p.y0 - p.radius, p.y1 - p.radius});
+    max_x = std::max({max_x, p.x0 + p.radius, p.x1 + p.radius});
+    max_y = std::max({max_y, p.y0 + p.radius, p.y1 + p.radius});
+  }
+  body.min_x = (int)std::floor(min_x);
+  body.min_y = (int)std::floor(min_y);
+  body.max_x = (int)std::ceil(max_x);
+  body.max_y = (int)std::ceil(max_y);
+  return body;
+}
+
+auto ore_body_map_t::build_region(int rx, int ry) const -> region_t
+{
+  const float size = (float)m_settings.region_size;
+  const float origin_x = (float)rx * size;
+  const float origin_y = (float)ry * size;
+
+  region_t region;
+  std::vector<candidate_t> candidates;
+
+  for (int ore_idx = 0; ore_idx < (int)m_settings.ores.size(); ore_idx++)
+  {
+    const auto &ore = m_settings.ores[ore_idx];
+    const float spacing = ore.spacing;
+
+    // Cell diagonal == spacing, so candidates closer than the spacing are at most 2 cells apart
+    const float cell = spacing / 1.41421356f;
+    const int gx0 = (int)std::floor(origin_x / cell) - 2;
+    const int gy0 = (int)std::floor(origin_y / cell) - 2;
+    const int gx1 = (int)std::floor((origin_x + size) / cell) + 2;
+    const int gy1 = (int)std::floor((origin_y + size) / cell) + 2;
+    const int cols = gx1 - gx0 + 1;
+    const int rows = gy1 - gy0 + 1;
+
+    candidates.clear();
+    for (int gy = gy0; gy <= gy1; gy++)
+    {
+      for (int gx = gx0; gx <= gx1; gx++)
+        candidates.push_back(make_candidate(ore_idx, cell, gx, gy));
+    }
+
+    for (int cy = 2; cy < rows - 2; cy++)
+    {
+      for (int cx = 2; cx < cols - 2; cx++)
+      {
+        const candidate_t &c = candidates[cy * cols + cx];
+        if (c.x < origin_x || c.y < origin_y || c.x >= origin_x + size || c.y >= origin_y + size)
+          continue; // Another region's
+
+        bool ok = true;
+        for (int ny = cy - 2; ok && ny <= cy + 2; ny++)
+        {
+          for (int nx = cx - 2; nx <= cx + 2; nx++)
+          {
+            const candidate_t &other = candidates[ny * cols + nx];
+            float dx = other.x - c.x;
+            float dy = other.y - c.y;
+            if (&other != &c && dx * dx + dy * dy < spacing * spacing && other.outranks(c))
+            {
+              ok = false;
+              break;
+            }
+          }
+        }
+        if (!ok)
+          continue;
+
+        uint32_t h = hash_coords((int)c.x, (int)c.y, m_seed ^ (ore_idx * 0x632be5ab));
+        if (hash_to_unit(h) >= ore.chance)
+          continue;
+        region.bodies.push_back(build_body(ore_idx, c.x, c.y, h));
+      }
+    }
+  }
+
+  return region;
+}
+
+auto ore_body_map_t::make_candidate(int ore_idx, float cell, int gx, int gy) const -> candidate_t
+{
+  uint32_t h = hash_coords(gx, gy, m_seed + ore_idx * 7919);
+  candidate_t c;
+  h = hash_u32(h);
+  c.x = ((float)gx + hash_to_unit(h)) * cell;
+  h = hash_u32(h);
+  c.y = ((float)gy + hash_to_unit(h)) * cell;
+  c.priority = hash_u32(h);
+  c.gx = gx;
+  c.gy = gy;
+  return c;
+}
+
+auto ore_body_map_t::stamp(int x0, int y0, int w, int h, uint8_t *out, const allow_fn &allow) const -> void
+{
+  if (!is_configured())
+    return;
+
+  const int size = m_settings.region_size;
+  const int x1 = x0 + w - 1;
+  const int y1 = y0 + h - 1;
+  const int rx0 = floor_div(x0 - m_max_extent, size);
+  const int rx1 = floor_div(x1 + m_max_extent, size);
+  const int ry0 = floor_div(y0 - m_max_extent, size);
+  const int ry1 = floor_div(y1 + m_max_extent, size);
+
+  // Gather first so later ores override earlier ones regardless of region order
+  std::vector<const body_t *> hits;
+  std::vector<std::shared_ptr<const region_t>> regions;
+  for (int ry = ry0; ry <= ry1; ry++)
+  {
+    for (int rx = rx0; rx <= rx1; rx++)
+    {
+      auto region = m_regions->get_or_create(rx, ry, [this](int x, int y) { return build_region(x, y); });
+      for (const auto &body : region->bodies)
+      {
+        if (body.max_x < x0 || body.min_x > x1 || body.max_y < y0 || body.min_y > y1)
+          continue;
+        hits.push_back(&body);
+      }
+      regions.push_back(std::move(region));
+    }
+  }
+  std::stable_sort(hits.begin(), hits.end(), [](const body_t *a, const body_t *b) { return a->ore < b->ore; });
+
+  for (const body_t *body : hits)
+  {
+    const int bx0 = std::max(body->min_x, x0);
+    const int bx1 = std::min(body->max_x, x1);
+    const int by0 = std::max(body->min_y, y0);
+    const int by1 = std::min(body->max_y, y1);
+    const uint8_t value = (uint8_t)(body->ore + 1);
+
+    for (const auto &part : body->parts)
+    {
+      const float dx = part.x1 - part.x0;
+      const float dy = part.y1 - part.y0;
+      const float len2 = dx * dx + dy * dy;
+      const float r2 = part.radius * part.radius;
+
+      for (int y = by0; y <= by1; y++)
+      {
+        float py = (float)y + 0.5f;
+        for (int x = bx0; x <= bx1; x++)
+        {
+          float px = (float)x + 0.5f;
+
+          // Distance to the segment (a disc when both ends coincide)
+          float t = (len2 > 0.0f) ? std::clamp(((px - part.x0) * dx + (py - part.y0) * dy) / len2, 0.0f, 1.0f) : 0.0f;
+          float ex = part.x0 + dx * t - px;
+          float ey = part.y0 + dy * t - py;
+          if (ex * ex + ey * ey <= r2 && (!allow || allow(body->ore, x, y)))
+            out[(y - y0) * w + (x - x0)] = value;
+        }
+      }
+    }
+  }
+}
+
+} // namespace deepbound
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "core/worldgen/region_cache.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace deepbound
+{
+
+enum class ore_shape_e
+{
+  blob, // A cluster of overlapping discs
+  vein  // A random walk of capsules
+};
+
+/**
+ * @brief Ore deposits placed as discrete bodies instead of per-tile noise tests.
+ *
+ * Body origins come from a jittered grid laid over the whole world per ore: each cell holds
+ * one candidate at a hashed position with a hashed priority, and a candidate becomes a body
+ * unless a higher priority one lies within the spacing. Everything is derived from hashes,
+ * so a region can tell which samples are its own (those inside it) without its neighbours,
+ * and the spacing holds across region borders. Shapes are built once per region as discs
+ * and capsules. A chunk only tests the bodies whose bounds overlap it.
+ */
+class ore_body_map_t
+{
+public:
+  struct ore_t
+  {
+    ore_shape_e shape = ore_shape_e::blob;
+    float spacing = 96.0f;   // Minimum distance between origins of this ore
+    float chance = 1.0f;     // Fraction of Poisson samples that become bodies
+    int min_size = 3;        // Blob radius, or vein length in steps
+    int max_size = 6;
+    float min_thickness = 1.0f; // Vein radius (blobs derive theirs from size)
+    float max_thickness = 2.0f;
+  };
+
+  struct settings_t
+  {
+    int region_size = 256; // Tiles per region edge
+    std::vector<ore_t> ores;
+  };
+
+  // One disc (x0 == x1, y0 == y1) or capsule of a body
+  struct part_t
+  {
+    float x0, y0;
+    float x1, y1;
+    float radius;
+  };
+
+  struct body_t
+  {
+    int ore;
+    int min_x, min_y, max_x, max_y; // Inclusive tile bounds
+    std::vector<part_t> parts;
+  };
+
+  ore_body_map_t() = default;
+
+  auto configure(const settings_t &settings, int seed) -> void;
+  auto is_configured() const -> bool
+  {
+    return !m_settings.ores.empty();
+  }
+
+  // Whether ore `ore` may replace tile (x, y), e.g. for depth and province rules
+  using allow_fn = std::function<bool(int ore, int x, int y)>;
+
+  // Writes ore index + 1 into `out` (w * h, row-major, origin x0/y0) wherever a body covers a
+  // tile and `allow` (if set) accepts it. Later ores win where bodies overlap; rejected and
+  // untouched tiles keep their value, so an earlier ore survives a later one it can't host.
+  auto stamp(int x0, int y0, int w, int h, uint8_t *out, const allow_fn &allow = {}) const -> void;
+
+private:
+  struct region_t
+  {
+    std::vector<body_t> bodies;
+  };
+
+  struct candidate_t
+  {
+    float x, y;
+    uint32_t priority;
+    int gx, gy; // Grid cell, breaks priority ties
+
+    auto outranks(const candidate_t &other) const -> bool
+    {
+      if (priority != other.priority)
+        return priority > other.priority;
+      return gx != other.gx ? gx > other.gx : gy > other.gy;
+    }
+  };
+
+  auto build_region(int rx, int ry) const -> region_t;
+  auto make_candidate(int ore, float cell, int gx, int gy) const -> candidate_t;
+  auto build_body(int ore, float x, float y, uint32_t hash) const -> body_t;
+
+  settings_t m_settings;
+  int m_seed = 0;
+  int m_max_extent = 0; // Furthest any body reaches from its region
+  std::shared_ptr<region_cache_t<region_t>> m_regions;
+};
+
+} // namespace deepbound
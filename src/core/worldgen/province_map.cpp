@@ -0,0 +1,180 @@
+#include "core/worldgen/province_map.hpp"
+#include "core/worldgen/coord_hash.hpp"
+#include "core/worldgen/floor_div.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DEEPBOUND_PROVINCE_SSE2 1
+#endif
+
+namespace deepbound
+{
+
+auto province_map_t::configure(const settings_t &settings, int province_count, FastNoise::SmartNode<> selector, int seed) -> void
+{
+  m_settings = settings;
+  m_settings.cell_size = std::max(m_settings.cell_size, 8);
+  m_settings.region_cells = std::max(m_settings.region_cells, 1);
+  m_settings.jitter = std::clamp(m_settings.jitter, 0.0f, 1.0f);
+  m_province_count = province_count;
+  m_selector = selector;
+  m_seed = seed;
+
+  // New layout, new cache. Chunks still holding old regions keep them alive until done.
+  m_regions = std::make_shared<region_cache_t<region_t>>(256);
+}
+
+auto province_map_t::get_cell_site(int cell_x, int cell_y) const -> site_t
+{
+  const float cell = (float)m_settings.cell_size;
+  uint32_t h = hash_coords(cell_x, cell_y, m_seed);
+  float jx = hash_to_unit(h) - 0.5f;
+  float jy = hash_to_unit(hash_u32(h)) - 0.5f;
+
+  site_t site;
+  site.x = ((float)cell_x + 0.5f + jx * m_settings.jitter) * cell;
+  site.y = ((float)cell_y + 0.5f + jy * m_settings.jitter) * cell;
+
+  // One selector sample per cell: neighbouring cells with similar values merge into larger provinces
+  float norm = hash_to_unit(hash_u32(h ^ 0x5bd1e995u));
+  if (m_selector)
+    norm = (m_selector->GenSingle2D(site.x, site.y, m_seed) + 1.0f) * 0.5f;
+  norm = std::clamp(norm, 0.0f, 0.99f);
+  site.province = (int)(norm * (float)m_province_count);
+
+  return site;
+}
+
+auto province_map_t::build_region(int rx, int ry) const -> region_t
+{
+  const int n = m_settings.region_cells;
+  region_t region;
+  region.sites.reserve(n * n);
+  for (int cy = 0; cy < n; cy++)
+  {
+    for (int cx = 0; cx < n; cx++)
+    {
+      region.sites.push_back(get_cell_site(rx * n + cx, ry * n + cy));
+    }
+  }
+  return region;
+}
+
+auto province_map_t::resolve_sites(float x0, float y0, float x1, float y1, std::vector<site_t> &out) const -> void
+{
+  out.clear();
+  if (!is_configured())
+    return;
+
+  const int cell = m_settings.cell_size;
+  const int n = m_settings.region_cells;
+
+  // With strong jitter a neighbour two cells away can still own part of this box
+  const int margin = (m_settings.jitter > 0.5f) ? 2 : 1;
+  const int cx0 = floor_div((int)std::floor(x0), cell) - margin;
+  const int cx1 = floor_div((int)std::floor(x1), cell) + margin;
+  const int cy0 = floor_div((int)std::floor(y0), cell) - margin;
+  const int cy1 = floor_div((int)std::floor(y1), cell) + margin;
+
+  std::vector<site_t> candidates;
+  candidates.reserve((cx1 - cx0 + 1) * (cy1 - cy0 + 1));
+
+  for (int cy = cy0; cy <= cy1; cy++)
+  {
+    int ry = floor_div(cy, n);
+    for (int cx = cx0; cx <= cx1; cx++)
+    {
+      int rx = floor_div(cx, n);
+      auto region = m_regions->get_or_create(rx, ry, [this](int x, int y) { return build_region(x, y); });
+      candidates.push_back(region->sites[(cy - ry * n) * n + (cx - rx * n)]);
+    }
+  }
+
+  // Prune: a site whose closest approach to the box is farther than some other site's
+  // farthest point can never win for any tile in the box.
+  auto dist2_min = [&](const site_t &s)
+  {
+    float dx = std::max({x0 - s.x, 0.0f, s.x - x1});
+    float dy = std::max({y0 - s.y, 0.0f, s.y - y1});
+    return dx * dx + dy * dy;
+  };
+  auto dist2_max = [&](const site_t &s)
+  {
+    float dx = std::max(std::abs(s.x - x0), std::abs(s.x - x1));
+    float dy = std::max(std::abs(s.y - y0), std::abs(s.y - y1));
+    return dx * dx + dy * dy;
+  };
+
+  float best_max = std::numeric_limits<float>::max();
+  for (const auto &s : candidates)
+    best_max = std::min(best_max, dist2_max(s));
+
+  for (const auto &s : candidates)
+  {
+    if (dist2_min(s) <= best_max)
+      out.push_back(s);
+  }
+}
+
+auto province_map_t::assign_nearest(const std::vector<site_t> &sites, const float *qx, const float *qy, int count, uint8_t *out_province) -> void
+{
+  if (sites.empty())
+  {
+    std::fill(out_province, out_province + count, (uint8_t)0);
+    return;
+  }
+
+  const int site_count = (int)sites.size();
+  int i = 0;
+
+#if defined(DEEPBOUND_PROVINCE_SSE2)
+  // 4 query points per iteration, sites scanned in order. Strict less-than keeps the
+  // lowest site index on ties, matching the scalar tail below.
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 px = _mm_loadu_ps(qx + i);
+    __m128 py = _mm_loadu_ps(qy + i);
+    __m128 best_d = _mm_set1_ps(std::numeric_limits<float>::max());
+    __m128i best_p = _mm_setzero_si128();
+
+    for (int s = 0; s < site_count; s++)
+    {
+      __m128 dx = _mm_sub_ps(px, _mm_set1_ps(sites[s].x));
+      __m128 dy = _mm_sub_ps(py, _mm_set1_ps(sites[s].y));
+      __m128 d = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+
+      __m128i closer = _mm_castps_si128(_mm_cmplt_ps(d, best_d));
+      best_d = _mm_min_ps(d, best_d);
+      best_p = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(sites[s].province)), _mm_andnot_si128(closer, best_p));
+    }
+
+    alignas(16) int32_t lanes[4];
+    _mm_store_si128((__m128i *)lanes, best_p);
+    for (int l = 0; l < 4; l++)
+      out_province[i + l] = (uint8_t)lanes[l];
+  }
+#endif
+
+  for (; i < count; i++)
+  {
+    float best_d = std::numeric_limits<float>::max();
+    int best_p = 0;
+    for (int s = 0; s < site_count; s++)
+    {
+      float dx = qx[i] - sites[s].x;
+      float dy = qy[i] - sites[s].y;
+      float d = dx * dx + dy * dy;
+      if (d < best_d)
+      {
+        best_d = d;
+        best_p = sites[s].province;
+      }
+    }
+    out_province[i] = (uint8_t)best_p;
+  }
+}
+
+} // namespace deepbound
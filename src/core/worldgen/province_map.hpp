@@ -0,0 +1,66 @@
+#pragma once
+
+#include "core/worldgen/region_cache.hpp"
+#include <cstdint>
+#include <vector>
+#include <FastNoise/FastNoise.h>
+
+namespace deepbound
+{
+
+/**
+ * @brief Geological province layout as jittered Voronoi cells over a coarse world grid.
+ *
+ * Each grid cell owns one site, placed at a hashed offset inside the cell, and one province
+ * index sampled from the province selector noise at that site. Sites and assignments are
+ * built per region (a square block of cells) and cached, so a chunk only resolves the few
+ * sites that can be nearest to one of its tiles.
+ */
+class province_map_t
+{
+public:
+  struct settings_t
+  {
+    int cell_size = 256;   // Tiles per cell edge
+    float jitter = 0.8f;   // 0 = regular grid, 1 = site anywhere in its cell
+    int region_cells = 8;  // Cells per region edge (cache granularity)
+  };
+
+  struct site_t
+  {
+    float x;
+    float y;
+    int province;
+  };
+
+  province_map_t() = default;
+
+  auto configure(const settings_t &settings, int province_count, FastNoise::SmartNode<> selector, int seed) -> void;
+  auto is_configured() const -> bool
+  {
+    return m_province_count > 0;
+  }
+
+  // Collects the sites that can be nearest to any point of [x0, x1] x [y0, y1] (inclusive, world tiles)
+  auto resolve_sites(float x0, float y0, float x1, float y1, std::vector<site_t> &out) const -> void;
+
+  // Nearest-site lookup for `count` query points. Writes the winning province index per point.
+  static auto assign_nearest(const std::vector<site_t> &sites, const float *qx, const float *qy, int count, uint8_t *out_province) -> void;
+
+private:
+  struct region_t
+  {
+    std::vector<site_t> sites; // region_cells * region_cells, row-major by cell y
+  };
+
+  auto build_region(int rx, int ry) const -> region_t;
+  auto get_cell_site(int cell_x, int cell_y) const -> site_t;
+
+  settings_t m_settings;
+  int m_province_count = 0;
+  int m_seed = 0;
+  FastNoise::SmartNode<> m_selector;
+  std::shared_ptr<region_cache_t<region_t>> m_regions;
+};
+
+} // namespace deepbound
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace deepbound
+{
+
+/**
+ * @brief Thread-safe cache of immutable per-region worldgen data.
+ *
+ * Chunk workers call get_or_create() concurrently. The first caller for a region builds it
+ * outside the lock; later callers for the same region wait on the shared future instead of
+ * building it twice. Entries are evicted in insertion order once the capacity is exceeded,
+ * and callers keep evicted data alive through the returned shared_ptr.
+ */
+template <typename T>
+class region_cache_t
+{
+public:
+  using value_ptr_t = std::shared_ptr<const T>;
+
+  explicit region_cache_t(size_t capacity = 256) : m_capacity(capacity)
+  {
+  }
+
+  template <typename F>
+  auto get_or_create(int rx, int ry, F &&build) -> value_ptr_t
+  {
+    const long long key = make_key(rx, ry);
+
+    std::promise<value_ptr_t> promise;
+    std::shared_future<value_ptr_t> future;
+    bool is_builder = false;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto it = m_entries.find(key);
+      if (it != m_entries.end())
+      {
+        future = it->second;
+      }
+      else
+      {
+        future = promise.get_future().share();
+        m_entries.emplace(key, future);
+        m_order.push_back(key);
+        is_builder = true;
+
+        while (m_order.size() > m_capacity)
+        {
+          m_entries.erase(m_order.front());
+          m_order.pop_front();
+        }
+      }
+    }
+
+    // Build outside the lock so other regions can proceed in parallel
+    if (is_builder)
+    {
+      try
+      {
+        promise.set_value(std::make_shared<const T>(build(rx, ry)));
+      }
+      catch (...)
+      {
+        promise.set_exception(std::current_exception());
+      }
+    }
+
+    return future.get();
+  }
+
+  auto clear() -> void
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_order.clear();
+  }
+
+  auto size() const -> size_t
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+  }
+
+private:
+  static auto make_key(int rx, int ry) -> long long
+  {
+    return ((long long)rx << 32) | (unsigned int)ry;
+  }
+
+  size_t m_capacity;
+  mutable std::mutex m_mutex;
+  std::unordered_map<long long, std::shared_future<value_ptr_t>> m_entries;
+  std::deque<long long> m_order;
+};
+
+} // namespace deepbound
@@ -0,0 +1,208 @@
+#include "core/worldgen/surface_erosion.hpp"
+#include "core/worldgen/floor_div.hpp"
+#include <algorithm>
+#include <cmath>
+#include <future>
+
+namespace deepbound
+{
+
+namespace
+{
+auto smoothstep(float t) -> float
+{
+  t = std::clamp(t, 0.0f, 1.0f);
+  return t * t * (3.0f - 2.0f * t);
+}
+
+auto erode_thermal(std::vector<float> &h, const surface_erosion_t::settings_t &settings) -> void
+{
+  const int n = (int)h.size();
+  std::vector<float> flux(n > 0 ? n - 1 : 0);
+
+  for (int it = 0; it < settings.thermal_iterations; it++)
+  {
+    // Flux per edge from the current state, then apply: scan order doesn't matter
+    for (int i = 0; i + 1 < n; i++)
+    {
+      float d = h[i] - h[i + 1];
+      float excess = std::abs(d) - settings.talus;
+      flux[i] = (excess > 0.0f) ? std::copysign(excess * settings.thermal_rate * 0.5f, d) : 0.0f;
+    }
+    for (int i = 0; i + 1 < n; i++)
+    {
+      h[i] -= flux[i];
+      h[i + 1] += flux[i];
+    }
+  }
+}
+
+auto erode_hydraulic(std::vector<float> &h, const surface_erosion_t::settings_t &settings) -> void
+{
+  const int n = (int)h.size();
+  if (n < 2)
+    return;
+
+  std::vector<float> water(n, 0.0f), sediment(n, 0.0f);
+  std::vector<float> d_water(n), d_sediment(n), outflow(n);
+
+  for (int it = 0; it < settings.hydraulic_iterations; it++)
+  {
+    for (int i = 0; i < n; i++)
+      water[i] += settings.rain;
+
+    // Water (and the sediment it carries) flows towards the lower water surface.
+    // Each cell has two edges, so capping each edge at half the source water keeps volume non-negative.
+    std::fill(d_water.begin(), d_water.end(), 0.0f);
+    std::fill(d_sediment.begin(), d_sediment.end(), 0.0f);
+    std::fill(outflow.begin(), outflow.end(), 0.0f);
+    for (int i = 0; i + 1 < n; i++)
+    {
+      float diff = (h[i] + water[i]) - (h[i + 1] + water[i + 1]);
+      int src = (diff > 0.0f) ? i : i + 1;
+      int dst = (diff > 0.0f) ? i + 1 : i;
+
+      float q = std::min(std::abs(diff) * 0.5f, water[src] * 0.5f);
+      if (q <= 0.0f)
+        continue;
+
+      float s = (water[src] > 1e-6f) ? sediment[src] * (q / water[src]) : 0.0f;
+      d_water[src] -= q;
+      d_water[dst] += q;
+      d_sediment[src] -= s;
+      d_sediment[dst] += s;
+      outflow[src] += q;
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+      water[i] += d_water[i];
+      sediment[i] += d_sediment[i];
+    }
+
+    // Pick up or drop sediment towards the carrying capacity of the water leaving each cell.
+    // Standing water (pits, flats) carries nothing, so it only deposits.
+    for (int i = 0; i < n; i++)
+    {
+      float lowest = h[i];
+      if (i > 0)
+        lowest = std::min(lowest, h[i - 1]);
+      if (i + 1 < n)
+        lowest = std::min(lowest, h[i + 1]);
+      float drop = h[i] - lowest;
+      float capacity = settings.capacity * drop * outflow[i];
+
+      if (sediment[i] < capacity)
+      {
+        // Never dig below half the drop to the lowest neighbour, or cells turn into pits
+        float amount = std::min(settings.erosion_rate * (capacity - sediment[i]), drop * 0.5f);
+        h[i] -= amount;
+        sediment[i] += amount;
+      }
+      else
+      {
+        float amount = settings.deposition_rate * (sediment[i] - capacity);
+        h[i] += amount;
+        sediment[i] -= amount;
+      }
+
+      water[i] *= (1.0f - settings.evaporation);
+    }
+  }
+
+  // Whatever is still suspended settles where it is
+  for (int i = 0; i < n; i++)
+    h[i] += sediment[i];
+}
+} // namespace
+
+auto surface_erosion_t::configure(const settings_t &settings, height_sampler_t sampler) -> void
+{
+  m_settings = settings;
+  m_settings.region_width = std::max(m_settings.region_width, 32);
+  m_settings.overlap = std::clamp(m_settings.overlap, 1, m_settings.region_width);
+  m_sampler = std::move(sampler);
+
+  m_windows = std::make_shared<region_cache_t<heights_t>>(64);
+  m_regions = std::make_shared<region_cache_t<heights_t>>(256);
+}
+
+auto surface_erosion_t::erode(std::vector<float> &heights, const settings_t &settings) -> void
+{
+  erode_thermal(heights, settings);
+  erode_hydraulic(heights, settings);
+}
+
+auto surface_erosion_t::build_window(int region) const -> heights_t
+{
+  const int width = m_settings.region_width + 2 * m_settings.overlap;
+  heights_t heights(width);
+  m_sampler(region * m_settings.region_width - m_settings.overlap, width, heights.data());
+  erode(heights, m_settings);
+  return heights;
+}
+
+auto surface_erosion_t::build_region(int region) const -> heights_t
+{
+  const int width = m_settings.region_width;
+  const int overlap = m_settings.overlap;
+
+  auto window_of = [this](int r) { return m_windows->get_or_create(r, 0, [this](int x, int) { return build_window(x); }); };
+
+  // The three windows are independent: erode the neighbours on worker threads
+  auto left_future = std::async(std::launch::async, window_of, region - 1);
+  auto right_future = std::async(std::launch::async, window_of, region + 1);
+  auto self = window_of(region);
+  auto left = left_future.get();
+  auto right = right_future.get();
+
+  // Window sample for world column (region_start + t) in window `r_offset` regions away
+  auto sample = [&](const heights_t &window, int r_offset, int t) { return window[t - r_offset * width + overlap]; };
+
+  heights_t heights(width);
+  for (int t = 0; t < width; t++)
+  {
+    float own = sample(*self, 0, t);
+
+    // Distance of the tile centre to the nearest seam; both sides of a seam weigh 50/50 there
+    float d_left = (float)t + 0.5f;
+    float d_right = (float)(width - t) - 0.5f;
+
+    if (d_left < (float)overlap)
+    {
+      float w_self = 0.5f + 0.5f * smoothstep(d_left / (float)overlap);
+      own = own * w_self + sample(*left, -1, t) * (1.0f - w_self);
+    }
+    else if (d_right < (float)overlap)
+    {
+      float w_self = 0.5f + 0.5f * smoothstep(d_right / (float)overlap);
+      own = own * w_self + sample(*right, 1, t) * (1.0f - w_self);
+    }
+
+    heights[t] = own;
+  }
+
+  return heights;
+}
+
+auto surface_erosion_t::get_heights(int x_start, int count, float *heights) const -> void
+{
+  if (!is_enabled())
+    return;
+
+  const int width = m_settings.region_width;
+  int i = 0;
+  while (i < count)
+  {
+    int x = x_start + i;
+    int region = floor_div(x, width);
+    auto eroded = m_regions->get_or_create(region, 0, [this](int r, int) { return build_region(r); });
+
+    int t = x - region * width;
+    int n = std::min(count - i, width - t);
+    std::copy(eroded->begin() + t, eroded->begin() + t + n, heights + i);
+    i += n;
+  }
+}
+
+} // namespace deepbound
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "core/worldgen/region_cache.hpp"
+#include <functional>
+#include <vector>
+
+namespace deepbound
+{
+
+/**
+ * @brief Optional thermal + hydraulic erosion of the 1D surface heightmap.
+ *
+ * The world is split into fixed-width regions along X. Each region is eroded over a window
+ * that extends `overlap` tiles into both neighbours; the result depends only on the seed and
+ * settings, never on which chunk asked first. Final heights cross-fade between neighbouring
+ * windows around each seam, so borders are continuous and deterministic. Windows are eroded
+ * in parallel and both windows and final regions are cached, so chunk generation only copies
+ * finished heights.
+ */
+class surface_erosion_t
+{
+public:
+  struct settings_t
+  {
+    bool enabled = false;
+    int region_width = 512; // Tiles per cached region
+    int overlap = 128;      // Extra tiles eroded on each side of a region
+
+    // Thermal: material slides down slopes steeper than `talus` (tiles of height per tile)
+    int thermal_iterations = 40;
+    float talus = 1.5f;
+    float thermal_rate = 0.5f;
+
+    // Hydraulic: rain picks up sediment on slopes and drops it where flow slows
+    int hydraulic_iterations = 30;
+    float rain = 0.02f;
+    float capacity = 4.0f;
+    float erosion_rate = 0.3f;
+    float deposition_rate = 0.3f;
+    float evaporation = 0.05f;
+  };
+
+  // Fills `out` with `count` un-eroded surface heights starting at `x_start`
+  using height_sampler_t = std::function<void(int x_start, int count, float *out)>;
+
+  surface_erosion_t() = default;
+
+  auto configure(const settings_t &settings, height_sampler_t sampler) -> void;
+  auto is_enabled() const -> bool
+  {
+    return m_settings.enabled && m_sampler;
+  }
+  auto get_settings() const -> const settings_t &
+  {
+    return m_settings;
+  }
+
+  // Overwrites heights[0..count) with eroded heights for columns x_start..x_start+count-1
+  auto get_heights(int x_start, int count, float *heights) const -> void;
+
+  // Erodes a heightmap in place. Jacobi-style updates keep the result independent of scan order.
+  static auto erode(std::vector<float> &heights, const settings_t &settings) -> void;
+
+private:
+  using heights_t = std::vector<float>;
+
+  auto build_window(int region) const -> heights_t;
+  auto build_region(int region) const -> heights_t;
+
+  settings_t m_settings;
+  height_sampler_t m_sampler;
+  std::shared_ptr<region_cache_t<heights_t>> m_windows;
+  std::shared_ptr<region_cache_t<heights_t>> m_regions;
+};
+
+} // namespace deepbound
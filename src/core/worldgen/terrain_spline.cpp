@@ -0,0 +1,277 @@
+#include "core/worldgen/terrain_spline.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define DEEPBOUND_SPLINE_AVX2 1
+#endif
+
+namespace deepbound
+{
+
+namespace
+{
+struct lut_view_t
+{
+  const float *data;
+  int stride;
+  float scale_x; // Maps [-1, 1] to [0, res_x - 1]
+  float scale_y;
+  float max_x;
+  float max_y;
+};
+
+#if defined(DEEPBOUND_SPLINE_AVX2)
+__attribute__((target("avx2"))) auto sample_lut_avx2(const lut_view_t &lut, const float *x, const float *secondary, int count, float *out) -> int
+{
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 scale_x = _mm256_set1_ps(lut.scale_x);
+  const __m256 scale_y = _mm256_set1_ps(lut.scale_y);
+  const __m256 max_x = _mm256_set1_ps(lut.max_x);
+  const __m256 max_y = _mm256_set1_ps(lut.max_y);
+  const __m256i stride = _mm256_set1_epi32(lut.stride);
+  const __m256i one_i = _mm256_set1_epi32(1);
+
+  int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 fx = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(x + i), one), scale_x);
+    fx = _mm256_min_ps(_mm256_max_ps(fx, zero), max_x);
+    __m256 fy = zero;
+    if (secondary)
+    {
+      fy = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(secondary + i), one), scale_y);
+      fy = _mm256_min_ps(_mm256_max_ps(fy, zero), max_y);
+    }
+
+    __m256i ix = _mm256_cvttps_epi32(fx);
+    __m256i iy = _mm256_cvttps_epi32(fy);
+    __m256 tx = _mm256_sub_ps(fx, _mm256_cvtepi32_ps(ix));
+    __m256 ty = _mm256_sub_ps(fy, _mm256_cvtepi32_ps(iy));
+
+    __m256i idx00 = _mm256_add_epi32(_mm256_mullo_epi32(iy, stride), ix);
+    __m256i idx10 = _mm256_add_epi32(idx00, one_i);
+    __m256i idx01 = _mm256_add_epi32(idx00, stride);
+    __m256i idx11 = _mm256_add_epi32(idx01, one_i);
+
+    __m256 v00 = _mm256_i32gather_ps(lut.data, idx00, 4);
+    __m256 v10 = _mm256_i32gather_ps(lut.data, idx10, 4);
+    __m256 v01 = _mm256_i32gather_ps(lut.data, idx01, 4);
+    __m256 v11 = _mm256_i32gather_ps(lut.data, idx11, 4);
+
+    // Same operation order as the scalar path, so both produce identical values
+    __m256 a = _mm256_add_ps(v00, _mm256_mul_ps(_mm256_sub_ps(v10, v00), tx));
+    __m256 b = _mm256_add_ps(v01, _mm256_mul_ps(_mm256_sub_ps(v11, v01), tx));
+    _mm256_storeu_ps(out + i, _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), ty)));
+  }
+  return i;
+}
+
+auto cpu_has_avx2() -> bool
+{
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+#endif
+} // namespace
+
+auto terrain_spline_t::parse_curve(const nlohmann::json &points, float at) -> curve_t
+{
+  curve_t curve;
+  curve.at = at;
+
+  std::vector<std::pair<float, float>> sorted;
+  for (const auto &p : points)
+  {
+    if (p.is_array() && p.size() >= 2)
+      sorted.push_back({p[0].get<float>(), p[1].get<float>()});
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+  for (const auto &[px, py] : sorted)
+  {
+    // Duplicate X would divide by zero below; keep the first
+    if (!curve.xs.empty() && px - curve.xs.back() < 1e-6f)
+      continue;
+    curve.xs.push_back(px);
+    curve.ys.push_back(py);
+  }
+
+  // Fritsch-Carlson tangents: monotone between points, no overshoot
+  const size_t n = curve.xs.size();
+  curve.tangents.assign(n, 0.0f);
+  if (n < 2)
+    return curve;
+
+  std::vector<float> secants(n - 1);
+  for (size_t k = 0; k + 1 < n; k++)
+    secants[k] = (curve.ys[k + 1] - curve.ys[k]) / (curve.xs[k + 1] - curve.xs[k]);
+
+  curve.tangents[0] = secants[0];
+  curve.tangents[n - 1] = secants[n - 2];
+  for (size_t k = 1; k + 1 < n; k++)
+    curve.tangents[k] = (secants[k - 1] * secants[k] <= 0.0f) ? 0.0f : (secants[k - 1] + secants[k]) * 0.5f;
+
+  for (size_t k = 0; k + 1 < n; k++)
+  {
+    if (secants[k] == 0.0f)
+    {
+      curve.tangents[k] = curve.tangents[k + 1] = 0.0f;
+      continue;
+    }
+    float alpha = curve.tangents[k] / secants[k];
+    float beta = curve.tangents[k + 1] / secants[k];
+    float len = alpha * alpha + beta * beta;
+    if (len > 9.0f)
+    {
+      float tau = 3.0f / std::sqrt(len);
+      curve.tangents[k] = tau * alpha * secants[k];
+      curve.tangents[k + 1] = tau * beta * secants[k];
+    }
+  }
+
+  return curve;
+}
+
+auto terrain_spline_t::curve_t::evaluate(float x) const -> float
+{
+  if (xs.empty())
+    return 0.0f;
+  if (x <= xs.front())
+    return ys.front();
+  if (x >= xs.back())
+    return ys.back();
+
+  size_t k = std::upper_bound(xs.begin(), xs.end(), x) - xs.begin() - 1;
+  float h = xs[k + 1] - xs[k];
+  float t = (x - xs[k]) / h;
+  float t2 = t * t;
+  float t3 = t2 * t;
+
+  float h00 = 2.0f * t3 - 3.0f * t2 + 1.0f;
+  float h10 = t3 - 2.0f * t2 + t;
+  float h01 = -2.0f * t3 + 3.0f * t2;
+  float h11 = t3 - t2;
+  return h00 * ys[k] + h10 * h * tangents[k] + h01 * ys[k + 1] + h11 * h * tangents[k + 1];
+}
+
+auto terrain_spline_t::from_json(const nlohmann::json &j) -> terrain_spline_t
+{
+  terrain_spline_t spline;
+
+  if (j.contains("points"))
+  {
+    spline.m_curves.push_back(parse_curve(j["points"], 0.0f));
+  }
+  else if (j.contains("curves"))
+  {
+    for (const auto &c : j["curves"])
+    {
+      if (c.contains("points"))
+        spline.m_curves.push_back(parse_curve(c["points"], c.value("at", 0.0f)));
+    }
+    std::sort(spline.m_curves.begin(), spline.m_curves.end(), [](const curve_t &a, const curve_t &b) { return a.at < b.at; });
+  }
+
+  spline.m_curves.erase(std::remove_if(spline.m_curves.begin(), spline.m_curves.end(), [](const curve_t &c) { return c.xs.empty(); }), spline.m_curves.end());
+  if (spline.m_curves.empty())
+    std::cerr << "Warning: Terrain spline has no points." << std::endl;
+
+  return spline;
+}
+
+auto terrain_spline_t::evaluate(float x, float secondary) const -> float
+{
+  if (m_curves.empty())
+    return 0.0f;
+  if (m_curves.size() == 1 || secondary <= m_curves.front().at)
+    return m_curves.front().evaluate(x);
+  if (secondary >= m_curves.back().at)
+    return m_curves.back().evaluate(x);
+
+  for (size_t k = 0; k + 1 < m_curves.size(); k++)
+  {
+    const auto &a = m_curves[k];
+    const auto &b = m_curves[k + 1];
+    if (secondary <= b.at)
+    {
+      float range = b.at - a.at;
+      float t = (range > 1e-6f) ? (secondary - a.at) / range : 0.0f;
+      float va = a.evaluate(x);
+      return va + (b.evaluate(x) - va) * t;
+    }
+  }
+  return m_curves.back().evaluate(x);
+}
+
+auto terrain_spline_t::bake(int resolution, int secondary_resolution) -> void
+{
+  m_res_x = std::max(resolution, 2);
+  m_res_y = is_2d() ? std::max(secondary_resolution, 2) : 1;
+  m_stride = m_res_x + 1;
+  m_lut.assign((size_t)m_stride * (m_res_y + 1), 0.0f);
+
+  for (int iy = 0; iy <= m_res_y; iy++)
+  {
+    int sy = std::min(iy, m_res_y - 1);
+    float secondary = (m_res_y > 1) ? -1.0f + 2.0f * (float)sy / (float)(m_res_y - 1) : 0.0f;
+    for (int ix = 0; ix <= m_res_x; ix++)
+    {
+      int sx = std::min(ix, m_res_x - 1);
+      float x = -1.0f + 2.0f * (float)sx / (float)(m_res_x - 1);
+      m_lut[(size_t)iy * m_stride + ix] = evaluate(x, secondary);
+    }
+  }
+}
+
+auto terrain_spline_t::sample_scalar(const float *x, const float *secondary, int begin, int end, float *out) const -> void
+{
+  const float scale_x = 0.5f * (float)(m_res_x - 1);
+  const float scale_y = 0.5f * (float)(m_res_y - 1);
+  const float max_x = (float)(m_res_x - 1);
+  const float max_y = (float)(m_res_y - 1);
+
+  for (int i = begin; i < end; i++)
+  {
+    float fx = std::min(std::max((x[i] + 1.0f) * scale_x, 0.0f), max_x);
+    float fy = secondary ? std::min(std::max((secondary[i] + 1.0f) * scale_y, 0.0f), max_y) : 0.0f;
+
+    int ix = (int)fx;
+    int iy = (int)fy;
+    float tx = fx - (float)ix;
+    float ty = fy - (float)iy;
+
+    const float *row = m_lut.data() + (size_t)iy * m_stride + ix;
+    float a = row[0] + (row[1] - row[0]) * tx;
+    float b = row[m_stride] + (row[m_stride + 1] - row[m_stride]) * tx;
+    out[i] = a + (b - a) * ty;
+  }
+}
+
+auto terrain_spline_t::sample(const float *x, const float *secondary, int count, float *out) const -> void
+{
+  if (m_lut.empty())
+  {
+    std::fill(out, out + count, 0.0f);
+    return;
+  }
+
+  // A 1D spline has a single row; skip the secondary lookup entirely
+  if (m_res_y == 1)
+    secondary = nullptr;
+
+  int done = 0;
+#if defined(DEEPBOUND_SPLINE_AVX2)
+  if (cpu_has_avx2())
+  {
+    lut_view_t lut = {m_lut.data(), m_stride, 0.5f * (float)(m_res_x - 1), 0.5f * (float)(m_res_y - 1), (float)(m_res_x - 1), (float)(m_res_y - 1)};
+    done = sample_lut_avx2(lut, x, secondary, count, out);
+  }
+#endif
+  sample_scalar(x, secondary, done, count, out);
+}
+
+} // namespace deepbound
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace deepbound
+{
+
+/**
+ * @brief Terrain shaping curve mapping continentalness (and optionally a second parameter) to a value.
+ *
+ * Defined in JSON either as a single curve:
+ *   { "points": [[-1.0, 350], [0.0, 505], [1.0, 900]] }
+ * or as several curves placed along the second parameter, blended linearly between them:
+ *   { "curves": [ { "at": -1.0, "points": [...] }, { "at": 1.0, "points": [...] } ] }
+ *
+ * Curves use monotone cubic interpolation (no overshoot between points). After loading, the
+ * spline is baked into a dense lookup table over [-1, 1] x [-1, 1]; sample() reads it with
+ * bilinear filtering, eight columns at a time with AVX2 gathers when the CPU supports them.
+ */
+class terrain_spline_t
+{
+public:
+  terrain_spline_t() = default;
+
+  static auto from_json(const nlohmann::json &j) -> terrain_spline_t;
+
+  auto empty() const -> bool
+  {
+    return m_curves.empty();
+  }
+  auto is_2d() const -> bool
+  {
+    return m_curves.size() > 1;
+  }
+
+  // Exact evaluation, used for baking
+  auto evaluate(float x, float secondary) const -> float;
+
+  // Bakes the lookup table. A 1D spline only ever uses one row.
+  auto bake(int resolution, int secondary_resolution) -> void;
+
+  // LUT lookup for `count` columns. `secondary` may be null for 1D splines.
+  auto sample(const float *x, const float *secondary, int count, float *out) const -> void;
+
+private:
+  struct curve_t
+  {
+    float at = 0.0f;
+    std::vector<float> xs;
+    std::vector<float> ys;
+    std::vector<float> tangents;
+
+    auto evaluate(float x) const -> float;
+  };
+
+  static auto parse_curve(const nlohmann::json &points, float at) -> curve_t;
+  auto sample_scalar(const float *x, const float *secondary, int begin, int end, float *out) const -> void;
+
+  std::vector<curve_t> m_curves; // Sorted by `at`
+
+  // Baked table: (m_res_y + 1) rows of (m_res_x + 1) values; the extra row/column repeats the
+  // last one so bilinear lookups never need a bounds check.
+  std::vector<float> m_lut;
+  int m_res_x = 0;
+  int m_res_y = 0;
+  int m_stride = 0;
+};
+
+} // namespace deepbound
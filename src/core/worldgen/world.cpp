@@ -1,21 +1,141 @@
 #include "core/worldgen/world.hpp"
 #include "core/worldgen/world_generator.hpp"
+#include "core/worldgen/chunk_store.hpp"
+#include "core/worldgen/floor_div.hpp"
 #include "core/content/tile.hpp"
+#include "core/content/tile_behavior.hpp"
+#include "core/common/metrics.hpp"
 #include <iostream>
 #include <future>
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <nlohmann/json.hpp>
 
 namespace deepbound
 {
 
-world_t::world_t()
+namespace
+{
+struct world_metrics_t
+{
+  metric_counter_t &chunks_generated = metrics_t::get().counter("deepbound_chunks_generated_total", "Chunks made by the world generator, not read from the save");
+  metric_counter_t &chunks_read = metrics_t::get().counter("deepbound_chunks_read_total", "Chunks loaded from the save instead of generated");
+  metric_counter_t &chunks_saved = metrics_t::get().counter("deepbound_chunks_saved_total", "Chunks queued for writing to the save");
+  metric_counter_t &chunks_unloaded = metrics_t::get().counter("deepbound_chunks_unloaded_total", "Chunks dropped for being far from the view");
+  metric_gauge_t &chunks_loaded = metrics_t::get().gauge("deepbound_chunks_loaded", "Chunks in memory");
+  metric_gauge_t &queue_depth = metrics_t::get().gauge("deepbound_chunk_queue_depth", "Chunks requested but not yet added");
+  metric_histogram_t &wait_seconds = metrics_t::get().histogram("deepbound_chunk_wait_seconds", "Chunk request to integration", metrics_t::seconds_buckets());
+  metric_gauge_t &memory = metrics_t::get().gauge("deepbound_memory_bytes", "Approximate memory use per subsystem", {{"subsystem", "chunks"}});
+};
+
+world_metrics_t &world_metrics()
+{
+  static world_metrics_t metrics;
+  return metrics;
+}
+
+// Fills the chunk from the save if it holds a copy
+bool load_saved_chunk(chunk_store_t *store, chunk_t &chunk, int cx, int cy)
+{
+  std::vector<uint8_t> data;
+  if (!store || !store->read(cx, cy, data) || !chunk_store_t::decode(data, chunk))
+    return false;
+  chunk.from_save = true;
+  world_metrics().chunks_read.add();
+  return true;
+}
+
+// Fills the chunk from the save, or from the generator if the save has no copy
+void load_or_generate_chunk(world_generator_t &generator, chunk_store_t *store, chunk_t &chunk, int cx, int cy)
+{
+  if (load_saved_chunk(store, chunk, cx, cy))
+    return;
+  generator.generate_chunk(&chunk, cx, cy);
+  world_metrics().chunks_generated.add();
+}
+
+// Where liquid of `type` can go at local (x, y) of `chunk`, which may be one chunk past an edge:
+// that chunk, with x and y made local to it and `room` set to how much fits. Null if it isn't
+// loaded, holds a solid tile or another liquid, or is full.
+chunk_t *liquid_target(chunk_t &chunk, int &x, int &y, uint16_t type, int &room)
+{
+  chunk_t *target = chunk.get_neighbour_at(x, y);
+  if (!target)
+    return nullptr;
+  const tile_definition_t *tile = target->get_tile(x, y);
+  if (tile && tile->is_solid)
+    return nullptr;
+  liquid_cell_t cell = target->get_liquid(x, y);
+  if (!cell.empty() && cell.type != type)
+    return nullptr; // Liquids don't mix
+  room = 255 - (cell.empty() ? 0 : cell.level);
+  return room > 0 ? target : nullptr;
+}
+
+// Autosave encodes at most this many chunks per frame
+constexpr size_t SAVES_PER_FRAME = 16;
+
+// Chunks more than this many chunks outside the last view are unloaded, a few per frame (an
+// edited one is saved on the way out)
+constexpr int UNLOAD_MARGIN = 2;
+constexpr size_t UNLOADS_PER_FRAME = 8;
+
+// Tile behaviours
+constexpr double TILE_TICK_SECONDS = 0.05;
+constexpr size_t TILE_UPDATES_PER_FRAME = 4096; // The rest waits, so a collapsing cave can't stall a frame
+constexpr double LIQUID_STEP_SECONDS = 0.1;
+
+// Worldgen configs in load order. A change to one also reloads `reload_also` (ores resolve
+// province names), -1 for none.
+struct config_part_t
+{
+  const char *path;
+  void (world_generator_t::*load)(const std::string &path);
+  int reload_also;
+};
+
+const std::array<config_part_t, 6> config_parts = {{
+    {"assets/worldgen/landforms.json", &world_generator_t::load_config, -1},
+    {"assets/worldgen/blocklayers.json", &world_generator_t::load_block_layers, -1},
+    {"assets/worldgen/caves.json", &world_generator_t::load_caves, -1},
+    {"assets/worldgen/provinces.json", &world_generator_t::load_provinces, 5},
+    {"assets/worldgen/aquifers.json", &world_generator_t::load_aquifers, -1},
+    {"assets/worldgen/ores.json", &world_generator_t::load_ores, -1},
+}};
+
+// FNV-1a of the file contents, 0 if it can't be read
+uint64_t hash_file(const std::string &path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open())
+    return 0;
+  std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : contents)
+    hash = (hash ^ c) * 1099511628211ull;
+  return hash;
+}
+} // namespace
+
+world_t::world_t(int seed)
 {
   // Initialize Generator
-  generator = std::make_unique<world_generator_t>(this);
+  generator = std::make_shared<world_generator_t>(this);
+  generator->set_seed(seed);
   // Load config relative to executable or known path
-  generator->load_config("assets/worldgen/landforms.json");
-  generator->load_block_layers("assets/worldgen/blocklayers.json");
-  generator->load_caves("assets/worldgen/caves.json");
-  generator->load_provinces("assets/worldgen/provinces.json");
+  for (const auto &part : config_parts)
+  {
+    (generator.get()->*part.load)(part.path);
+
+    std::error_code ec;
+    config_files.push_back({part.path, std::filesystem::last_write_time(part.path, ec), hash_file(part.path)});
+  }
 
   // Pre-generate some chunks around user spawn?
   // Let's just generate the origin (0,0) chunk for now to verify.
@@ -24,12 +144,146 @@ world_t::world_t()
 
 world_t::~world_t()
 {
+  save_all();
+}
+
+bool world_t::enable_saving(const std::string &directory, double interval)
+{
+  std::error_code ec;
+  std::filesystem::create_directories(directory, ec);
+
+  // The seed decides everything that was never edited, so a save only makes sense with its own
+  const std::string info_path = directory + "/world.json";
+  std::ifstream info_in(info_path);
+  if (info_in.is_open())
+  {
+    try
+    {
+      nlohmann::json j;
+      info_in >> j;
+      int saved_seed = j.value("seed", get_seed());
+      if (saved_seed != get_seed())
+      {
+        std::cerr << "Save " << directory << " belongs to seed " << saved_seed << ", not " << get_seed() << std::endl;
+        return false;
+      }
+    }
+    catch (const std::exception &e)
+    {
+      std::cerr << "Failed to parse " << info_path << ": " << e.what() << std::endl;
+      return false;
+    }
+  }
+  else
+  {
+    std::ofstream info_out(info_path);
+    if (!info_out.is_open())
+    {
+      std::cerr << "Failed to write " << info_path << std::endl;
+      return false;
+    }
+    info_out << nlohmann::json{{"version", 1}, {"seed", get_seed()}}.dump(2) << std::endl;
+  }
+
+  store = std::make_shared<chunk_store_t>(directory);
+  autosave_interval = interval;
+  autosave_timer = 0.0;
+  return true;
+}
+
+void world_t::save_all()
+{
+  if (!store)
+    return;
+  save_queue.clear();
+
+  // A second round writes what failed in the first, then the rest is reported lost
+  for (int attempt = 0; attempt < 2; attempt++)
+  {
+    if (attempt > 0)
+      retry_failed_saves();
+    for (auto &[key, chunk] : chunks)
+    {
+      if (chunk->needs_save())
+        save_chunk(*chunk);
+    }
+    store->flush();
+  }
+  for (const auto &[cx, cy] : store->take_failed())
+    std::cerr << "Could not save chunk " << cx << ", " << cy << std::endl;
+}
+
+void world_t::retry_failed_saves()
+{
+  for (const auto &[cx, cy] : store->take_failed())
+  {
+    if (chunk_t *chunk = find_chunk(cx, cy))
+      chunk->saved_version = chunk->edit_version - 1; // Anything else: still needs saving
+    else
+      store->retry(cx, cy); // Unloaded, the store's copy is all that's left
+  }
+}
+
+void world_t::save_chunk(chunk_t &chunk)
+{
+  store->write(chunk.get_x(), chunk.get_y(), chunk_store_t::encode(chunk));
+  chunk.saved_version = chunk.edit_version;
+  world_metrics().chunks_saved.add();
+}
+
+void world_t::update_autosave(double delta_time)
+{
+  if (!store)
+    return;
+  retry_failed_saves();
+
+  autosave_timer += delta_time;
+  if (autosave_timer >= autosave_interval && save_queue.empty())
+  {
+    autosave_timer = 0.0;
+    for (const auto &[key, chunk] : chunks)
+    {
+      if (chunk->needs_save())
+        save_queue.push_back(key);
+    }
+  }
+
+  // Encoding is quick but a busy world has many changed chunks: spread them over frames. The
+  // writes themselves happen on the store's I/O threads.
+  for (size_t i = 0; i < SAVES_PER_FRAME && !save_queue.empty(); i++)
+  {
+    auto it = chunks.find(save_queue.back());
+    save_queue.pop_back();
+    if (it != chunks.end() && it->second->needs_save())
+      save_chunk(*it->second);
+  }
 }
 
 void world_t::update(double delta_time)
 {
   // Update chunks, simulate water, entities...
   update_chunks();
+
+  if (watch_config)
+  {
+    config_check_timer += delta_time;
+    if (config_check_timer >= 1.0)
+    {
+      config_check_timer = 0.0;
+      check_config_changes();
+    }
+  }
+  schedule_regeneration();
+  update_tiles(delta_time);
+  update_liquids(delta_time);
+  update_autosave(delta_time);
+  update_unloading();
+
+  auto &metrics = world_metrics();
+  metrics.chunks_loaded.set((double)chunks.size());
+  metrics.queue_depth.set((double)pending_chunks.size());
+
+  metrics.memory.set((double)chunk_memory_bytes);
 }
 
 void world_t::update_chunks()
@@ -40,9 +294,26 @@ void world_t::update_chunks()
     if (it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
     {
       // Ready!
-      auto new_chunk = it->second.get();
-      long long key = it->first;
-      chunks[key] = std::move(new_chunk);
+      auto ready = it->second.get();
+      auto existing = chunks.find(it->first);
+      if (existing != chunks.end() && existing->second->has_player_changes())
+      {
+        // Edited while its regeneration was running: the edits win
+        pending_info.erase(it->first);
+        it = pending_chunks.erase(it);
+        continue;
+      }
+      chunk_t *chunk = integrate_chunk(it->first, std::move(ready));
+
+      auto info = pending_info.find(it->first);
+      if (info != pending_info.end())
+      {
+        double wait_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - info->second.since).count();
+        chunk->pipeline.wait_ms = (float)wait_ms;
+        chunk_latencies_ms.push_back(wait_ms);
+        world_metrics().wait_seconds.observe(wait_ms / 1000.0);
+        pending_info.erase(info);
+      }
 
       it = pending_chunks.erase(it);
     }
@@ -92,6 +363,241 @@ const tile_definition_t *world_t::get_tile_at(int x, int y) const
   return nullptr; // No chunk or Air
 }
 
+bool world_t::set_tile_at(int x, int y, const tile_definition_t *tile)
+{
+  // Liquids live in their own layer (set_liquid_at)
+  if (tile && tile->draw_type == "liquid")
+    return false;
+  chunk_t *chunk = find_chunk(floor_div(x, chunk_t::SIZE), floor_div(y, chunk_t::SIZE));
+  if (!chunk)
+    return false;
+
+  int lx = x - chunk->x;
+  int ly = y - chunk->y;
+  if (tile && tile->is_solid && !displace_liquid(*chunk, lx, ly))
+    return false;
+  chunk->set_tile(lx, ly, tile);
+  chunk->mark_edited();
+  refresh_autotile(*chunk, lx, ly, lx, ly);
+  wake_liquids(*chunk, lx, ly);
+
+  const uint16_t index = (uint16_t)(lx * chunk_t::SIZE + ly);
+  auto &ticking = chunk->ticking_tiles;
+  ticking.erase(std::remove(ticking.begin(), ticking.end(), index), ticking.end());
+  if (tile_behavior_registry_t::get().get_flags(tile) & tile_behavior_flags::ticks)
+    ticking.push_back(index);
+  queue_tile_updates(x, y);
+  return true;
+}
+
+bool world_t::is_tile_loaded(int x, int y) const
+{
+  return find_chunk(floor_div(x, chunk_t::SIZE), floor_div(y, chunk_t::SIZE)) != nullptr;
+}
+
+liquid_cell_t world_t::get_liquid_at(int x, int y) const
+{
+  chunk_t *chunk = find_chunk(floor_div(x, chunk_t::SIZE), floor_div(y, chunk_t::SIZE));
+  return chunk ? chunk->get_liquid(x - chunk->x, y - chunk->y) : liquid_cell_t{};
+}
+
+bool world_t::set_liquid_at(int x, int y, liquid_cell_t cell)
+{
+  chunk_t *chunk = find_chunk(floor_div(x, chunk_t::SIZE), floor_div(y, chunk_t::SIZE));
+  if (!chunk)
+    return false;
+  chunk->set_liquid(x - chunk->x, y - chunk->y, cell);
+  chunk->mark_edited();
+  wake_liquids(*chunk, x - chunk->x, y - chunk->y);
+  return true;
+}
+
+void world_t::wake_liquids(chunk_t &chunk, int lx, int ly)
+{
+  for (int oy = -1; oy <= 1; oy++)
+  {
+    for (int ox = -1; ox <= 1; ox++)
+    {
+      int x = lx + ox;
+      int y = ly + oy;
+      if (chunk_t *other = chunk.get_neighbour_at(x, y))
+        other->liquids.wake(x, y);
+    }
+  }
+}
+
+void world_t::update_liquids(double delta_time)
+{
+  liquid_timer += delta_time;
+  if (liquid_timer < LIQUID_STEP_SECONDS)
+    return;
+  liquid_timer = std::fmod(liquid_timer, LIQUID_STEP_SECONDS);
+  liquid_step++;
+
+  // Taken up front: flows during this step wake sections for the next one. Settled liquid (all of
+  // a freshly generated world) is never visited.
+  std::vector<std::pair<chunk_t *, uint16_t>> active;
+  for (auto &[key, chunk] : chunks)
+  {
+    if (!chunk->liquids.is_awake())
+      continue;
+    uint16_t sections = chunk->liquids.take_awake() & chunk->liquids.get_mask();
+    if (sections)
+      active.push_back({chunk.get(), sections});
+  }
+
+  constexpr int SECTION = liquid_layer_t::SECTION;
+  for (auto [chunk, sections] : active)
+  {
+    for (int s = 0; s < liquid_layer_t::SECTIONS_PER_EDGE * liquid_layer_t::SECTIONS_PER_EDGE; s++)
+    {
+      if (!(sections & (1u << s)))
+        continue;
+      const int x0 = (s % liquid_layer_t::SECTIONS_PER_EDGE) * SECTION;
+      const int y0 = (s / liquid_layer_t::SECTIONS_PER_EDGE) * SECTION;
+      // Bottom up, so a falling column moves together
+      for (int ly = y0; ly < y0 + SECTION; ly++)
+      {
+        for (int lx = x0; lx < x0 + SECTION; lx++)
+          step_liquid(*chunk, lx, ly);
+      }
+    }
+  }
+}
+
+void world_t::step_liquid(chunk_t &chunk, int lx, int ly)
+{
+  liquid_cell_t cell = chunk.get_liquid(lx, ly);
+  if (cell.empty())
+    return;
+
+  // Fall first, then level out with the sides. The side tried first alternates, so nothing drifts.
+  int level = cell.level - flow_liquid(chunk, lx, ly, lx, ly - 1, cell.level);
+  int dir = ((chunk.x + lx + liquid_step) & 1) ? 1 : -1;
+  for (int side = 0; side < 2 && level > 1; side++, dir = -dir)
+  {
+    int diff = level - chunk.get_liquid_around(lx + dir, ly).level;
+    if (diff >= 2)
+      level -= flow_liquid(chunk, lx, ly, lx + dir, ly, std::max(1, diff / 3));
+  }
+}
+
+int world_t::flow_liquid(chunk_t &from, int lx, int ly, int tx, int ty, int amount)
+{
+  liquid_cell_t source = from.get_liquid(lx, ly);
+  int room = 0;
+  chunk_t *target = liquid_target(from, tx, ty, source.type, room);
+  const int moved = std::min(amount, room);
+  if (!target || moved <= 0)
+    return 0;
+
+  liquid_cell_t dest = target->get_liquid(tx, ty);
+  target->set_liquid(tx, ty, {source.type, (uint8_t)((dest.empty() ? 0 : dest.level) + moved)});
+  from.set_liquid(lx, ly, {source.type, (uint8_t)(source.level - moved)});
+  from.mark_edited();
+  target->mark_edited();
+  wake_liquids(from, lx, ly);
+  wake_liquids(*target, tx, ty);
+  return moved;
+}
+
+bool world_t::displace_liquid(chunk_t &chunk, int lx, int ly)
+{
+  liquid_cell_t cell = chunk.get_liquid(lx, ly);
+  if (cell.empty())
+    return true;
+
+  // Up first, then the sides, then down. All or nothing, so no liquid is lost.
+  static constexpr int directions[4][2] = {{0, 1}, {-1, 0}, {1, 0}, {0, -1}};
+  int total_room = 0;
+  for (const auto &[dx, dy] : directions)
+  {
+    int tx = lx + dx;
+    int ty = ly + dy;
+    int room = 0;
+    if (liquid_target(chunk, tx, ty, cell.type, room))
+      total_room += room;
+  }
+  if (total_room < cell.level)
+    return false;
+
+  int left = cell.level;
+  for (const auto &[dx, dy] : directions)
+    left -= flow_liquid(chunk, lx, ly, lx + dx, ly + dy, left);
+  return true;
+}
+
+void world_t::queue_tile_updates(int x, int y)
+{
+  const auto &behaviors = tile_behavior_registry_t::get();
+  for (int oy = -1; oy <= 1; oy++)
+  {
+    for (int ox = -1; ox <= 1; ox++)
+    {
+      if (behaviors.get_flags(get_tile_at(x + ox, y + oy)) & tile_behavior_flags::neighbour_changed)
+        tile_updates.push_back({x + ox, y + oy});
+    }
+  }
+}
+
+void world_t::update_tiles(double delta_time)
+{
+  const auto &behaviors = tile_behavior_registry_t::get();
+
+  // Neighbour changes. Edits made by handlers queue more, which run next frame.
+  size_t count = std::min(tile_updates.size(), TILE_UPDATES_PER_FRAME);
+  std::vector<tile_update_t> updates(tile_updates.begin(), tile_updates.begin() + count);
+  tile_updates.erase(tile_updates.begin(), tile_updates.begin() + count);
+  for (const auto &update : updates)
+  {
+    const tile_definition_t *tile = get_tile_at(update.x, update.y);
+    if (!tile)
+      continue;
+    for (auto handler : behaviors.get_dispatch(*tile).on_neighbour_changed)
+    {
+      handler(*this, update.x, update.y, *tile);
+      if (get_tile_at(update.x, update.y) != tile)
+        break; // The tile is gone, its other handlers no longer apply
+    }
+  }
+
+  // Ticks only visit tiles that have tick handlers
+  tile_tick_timer += delta_time;
+  if (tile_tick_timer < TILE_TICK_SECONDS)
+    return;
+  tile_tick_timer = std::fmod(tile_tick_timer, TILE_TICK_SECONDS);
+  for (auto &[key, chunk] : chunks)
+  {
+    if (chunk->ticking_tiles.empty())
+      continue;
+    const std::vector<uint16_t> ticking = chunk->ticking_tiles; // Handlers may edit the list
+    for (uint16_t index : ticking)
+    {
+      const tile_definition_t *tile = chunk->tiles[index];
+      if (!tile)
+        continue;
+      const int x = chunk->x + index / chunk_t::SIZE;
+      const int y = chunk->y + index % chunk_t::SIZE;
+      for (auto handler : behaviors.get_dispatch(*tile).on_tick)
+      {
+        handler(*this, x, y, *tile);
+        if (chunk->tiles[index] != tile)
+          break;
+      }
+    }
+  }
+}
+
+int world_t::get_seed() const
+{
+  return generator ? generator->get_seed() : 0;
+}
+
+std::vector<double> world_t::take_chunk_latencies_ms()
+{
+  return std::exchange(chunk_latencies_ms, {});
+}
+
 bool world_t::is_solid(float x, float y) const
 {
   auto t = get_tile_at(x, y);
@@ -112,6 +618,11 @@ std::vector<chunk_t *> world_t::get_visible_chunks(const glm::vec2 &camera_pos,
   if (cy_end > 32)
     cy_end = 32;
 
+  const auto now = std::chrono::steady_clock::now();
+  focus_cx = floor_div((int)floor(camera_pos.x), chunk_t::SIZE);
+  focus_cy = floor_div((int)floor(camera_pos.y), chunk_t::SIZE);
+  focus_view_distance = view_distance;
+
   // 1. Identify Existing vs Missing
   for (int cx = cx_start; cx <= cx_end; cx++)
   {
@@ -123,6 +634,7 @@ std::vector<chunk_t *> world_t::get_visible_chunks(const glm::vec2 &camera_pos,
       auto it = chunks.find(key);
       if (it != chunks.end())
       {
+        it->second->pipeline.last_visible = now;
         visible.push_back(it->second.get());
       }
       else
@@ -131,15 +643,7 @@ std::vector<chunk_t *> world_t::get_visible_chunks(const glm::vec2 &camera_pos,
         if (pending_chunks.find(key) == pending_chunks.end() && generator)
         {
           // c) Launch Async (If not duplicate)
-          pending_chunks[key] = std::async(std::launch::async,
-                                           [this, cx, cy]()
-                                           {
-                                             auto new_chunk = std::make_unique<chunk_t>();
-                                             new_chunk->x = cx * chunk_t::SIZE;
-                                             new_chunk->y = cy * chunk_t::SIZE;
-                                             this->generator->generate_chunk(new_chunk.get(), cx, cy);
-                                             return new_chunk;
-                                           });
+          request_chunk(key, cx, cy);
         }
       }
     }
@@ -148,6 +652,116 @@ std::vector<chunk_t *> world_t::get_visible_chunks(const glm::vec2 &camera_pos,
   return visible;
 }
 
+void world_t::request_chunk(long long key, int cx, int cy)
+{
+  auto started = std::make_shared<std::atomic<bool>>(false);
+  pending_info[key] = {std::chrono::steady_clock::now(), started};
+  pending_chunks[key] = std::async(std::launch::async,
+                                   [gen = generator, store = store, version = generator_version, cx, cy, started]()
+                                   {
+                                     started->store(true, std::memory_order_relaxed);
+                                     auto start = std::chrono::steady_clock::now();
+                                     auto new_chunk = std::make_unique<chunk_t>();
+                                     new_chunk->x = cx * chunk_t::SIZE;
+                                     new_chunk->y = cy * chunk_t::SIZE;
+                                     new_chunk->generator_version = version;
+                                     load_or_generate_chunk(*gen, store.get(), *new_chunk, cx, cy);
+                                     new_chunk->pipeline.generate_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+                                     return new_chunk;
+                                   });
+}
+
+void world_t::check_config_changes()
+{
+  std::array<bool, config_parts.size()> changed = {};
+  bool any = false;
+  for (size_t i = 0; i < config_parts.size(); i++)
+  {
+    auto &file = config_files[i];
+    std::error_code ec;
+    auto modified = std::filesystem::last_write_time(file.path, ec);
+    if (ec || modified == file.modified)
+      continue;
+    file.modified = modified;
+
+    // Saved without changes (or only touched): nothing to do
+    uint64_t hash = hash_file(file.path);
+    if (hash == file.hash)
+      continue;
+    file.hash = hash;
+
+    changed[i] = true;
+    if (config_parts[i].reload_also >= 0)
+      changed[config_parts[i].reload_also] = true;
+    any = true;
+  }
+  if (!any)
+    return;
+
+  // Rebuild only the changed parts, on a copy; workers keep using the current generator meanwhile
+  auto start = std::chrono::steady_clock::now();
+  std::shared_ptr<world_generator_t> next = generator->clone();
+  std::string names;
+  try
+  {
+    for (size_t i = 0; i < config_parts.size(); i++)
+    {
+      if (!changed[i])
+        continue;
+      (next.get()->*config_parts[i].load)(config_parts[i].path);
+      names += std::string(names.empty() ? "" : ", ") + std::filesystem::path(config_parts[i].path).filename().string();
+    }
+  }
+  catch (const std::exception &e)
+  {
+    // Usually a half-saved file; the next save triggers another attempt
+    std::cerr << "Worldgen reload failed, keeping the current generator: " << e.what() << std::endl;
+    return;
+  }
+
+  generator = std::move(next);
+  generator_version++;
+  regenerating = true;
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "Reloaded " << names << " in " << ms << " ms, regenerating " << chunks.size() << " chunks" << std::endl;
+}
+
+void world_t::schedule_regeneration()
+{
+  if (!regenerating)
+    return;
+
+  const size_t max_in_flight = std::max(2u, std::thread::hardware_concurrency());
+  if (pending_chunks.size() >= max_in_flight)
+    return;
+
+  // Stale chunks nearest the camera first, so what's on screen updates first
+  std::vector<std::pair<int, long long>> stale;
+  for (const auto &[key, chunk] : chunks)
+  {
+    if (chunk->generator_version == generator_version || pending_chunks.find(key) != pending_chunks.end())
+      continue;
+    if (chunk->has_player_changes())
+      chunk->generator_version = generator_version; // Edits and saved chunks win over new worldgen
+    else
+      stale.push_back({std::max(std::abs(chunk->get_x() - focus_cx), std::abs(chunk->get_y() - focus_cy)), key});
+  }
+  if (stale.empty())
+  {
+    // Done once nothing generated with an older generator can still arrive
+    regenerating = !pending_chunks.empty();
+    return;
+  }
+
+  size_t count = std::min(stale.size(), max_in_flight - pending_chunks.size());
+  std::partial_sort(stale.begin(), stale.begin() + count, stale.end());
+  for (size_t i = 0; i < count; i++)
+  {
+    const chunk_t *chunk = chunks[stale[i].second].get();
+    request_chunk(stale[i].second, chunk->get_x(), chunk->get_y());
+  }
+}
+
 chunk_t *world_t::get_chunk(int cx, int cy)
 {
   long long key = get_chunk_key(cx, cy);
@@ -162,13 +776,173 @@ chunk_t *world_t::get_chunk(int cx, int cy)
 
     if (generator)
     {
-      generator->generate_chunk(new_chunk.get(), cx, cy);
+      new_chunk->generator_version = generator_version;
+      auto start = std::chrono::steady_clock::now();
+      load_or_generate_chunk(*generator, store.get(), *new_chunk, cx, cy);
+      new_chunk->pipeline.generate_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
     }
 
-    chunks[key] = std::move(new_chunk);
+    return integrate_chunk(key, std::move(new_chunk));
   }
 
   return chunks[key].get();
 }
 
+world_t::chunk_load_state_e world_t::get_chunk_load_state(int cx, int cy) const
+{
+  long long key = get_chunk_key(cx, cy);
+  if (chunks.count(key))
+    return chunk_load_state_e::loaded;
+  auto info = pending_info.find(key);
+  if (info == pending_info.end())
+    return chunk_load_state_e::none;
+  return info->second.started->load(std::memory_order_relaxed) ? chunk_load_state_e::generating : chunk_load_state_e::requested;
+}
+
+chunk_t *world_t::find_chunk(int cx, int cy) const
+{
+  auto it = chunks.find(get_chunk_key(cx, cy));
+  return it != chunks.end() ? it->second.get() : nullptr;
+}
+
+chunk_t *world_t::integrate_chunk(long long key, std::unique_ptr<chunk_t> new_chunk)
+{
+  chunk_t *chunk = new_chunk.get();
+  auto &slot = chunks[key];
+  if (slot)
+    chunk_memory_bytes -= slot->memory_bytes(); // A regenerated copy replacing the old one
+  chunk->memory_total = &chunk_memory_bytes;
+  chunk_memory_bytes += chunk->memory_bytes();
+  slot = std::move(new_chunk);
+
+  const auto &behaviors = tile_behavior_registry_t::get();
+  for (size_t i = 0; i < chunk->tiles.size(); i++)
+  {
+    if (behaviors.get_flags(chunk->tiles[i]) & tile_behavior_flags::ticks)
+      chunk->ticking_tiles.push_back((uint16_t)i);
+  }
+
+  const int cx = chunk->get_x();
+  const int cy = chunk->get_y();
+  for (int oy = -1; oy <= 1; oy++)
+  {
+    for (int ox = -1; ox <= 1; ox++)
+    {
+      if (ox == 0 && oy == 0)
+        continue;
+      chunk_t *other = find_chunk(cx + ox, cy + oy);
+      chunk->neighbours[(oy + 1) * 3 + (ox + 1)] = other;
+      if (other)
+        other->neighbours[(1 - oy) * 3 + (1 - ox)] = chunk;
+    }
+  }
+
+  // Its own masks, plus the border rows of neighbours that now have a halo
+  refresh_autotile(*chunk, 0, 0, chunk_t::SIZE - 1, chunk_t::SIZE - 1);
+  return chunk;
+}
+
+void world_t::update_unloading()
+{
+  if (focus_view_distance < 0)
+    return;
+
+  const int keep = focus_view_distance + UNLOAD_MARGIN;
+  std::vector<std::pair<int, int>> far;
+  for (const auto &[key, chunk] : chunks)
+  {
+    if (std::abs(chunk->get_x() - focus_cx) <= keep && std::abs(chunk->get_y() - focus_cy) <= keep)
+      continue;
+    // Not while a regenerated copy is on its way, it would just be added again
+    if (pending_chunks.count(key))
+      continue;
+    far.push_back({chunk->get_x(), chunk->get_y()});
+    if (far.size() >= UNLOADS_PER_FRAME)
+      break;
+  }
+
+  for (const auto &[cx, cy] : far)
+    unload_chunk(cx, cy);
+}
+
+void world_t::unload_chunk(int cx, int cy)
+{
+  auto it = chunks.find(get_chunk_key(cx, cy));
+  if (it == chunks.end())
+    return;
+
+  chunk_t *chunk = it->second.get();
+  if (store && chunk->needs_save())
+    save_chunk(*chunk);
+  auto around = chunk->neighbours;
+  for (int oy = -1; oy <= 1; oy++)
+  {
+    for (int ox = -1; ox <= 1; ox++)
+    {
+      chunk_t *other = around[(oy + 1) * 3 + (ox + 1)];
+      if (other && other != chunk)
+        other->neighbours[(1 - oy) * 3 + (1 - ox)] = nullptr;
+    }
+  }
+  chunk_memory_bytes -= chunk->memory_bytes();
+  chunks.erase(it);
+  world_metrics().chunks_unloaded.add();
+
+  // Border tiles of the neighbours lose their connections into this chunk
+  for (int oy = -1; oy <= 1; oy++)
+  {
+    for (int ox = -1; ox <= 1; ox++)
+    {
+      chunk_t *other = around[(oy + 1) * 3 + (ox + 1)];
+      if ((ox == 0 && oy == 0) || !other)
+        continue;
+      int y_begin = (oy == -1) ? chunk_t::SIZE - 1 : 0;
+      int y_end = (oy == 1) ? 1 : chunk_t::SIZE;
+      refresh_autotile_rows(*other, y_begin, y_end);
+    }
+  }
+}
+
+void world_t::refresh_autotile(chunk_t &chunk, int lx0, int ly0, int lx1, int ly1)
+{
+  // A tile's mask depends on its 8 neighbours, so everything within one tile of the rect
+  for (int oy = -1; oy <= 1; oy++)
+  {
+    for (int ox = -1; ox <= 1; ox++)
+    {
+      chunk_t *other = chunk.get_neighbour(ox, oy);
+      if (!other)
+        continue;
+
+      // The rect in the other chunk's local coordinates
+      int x0 = lx0 - 1 - ox * chunk_t::SIZE;
+      int x1 = lx1 + 1 - ox * chunk_t::SIZE;
+      int y0 = ly0 - 1 - oy * chunk_t::SIZE;
+      int y1 = ly1 + 1 - oy * chunk_t::SIZE;
+      if (x1 < 0 || x0 >= chunk_t::SIZE || y1 < 0 || y0 >= chunk_t::SIZE)
+        continue;
+
+      refresh_autotile_rows(*other, std::max(y0, 0), std::min(y1 + 1, chunk_t::SIZE));
+    }
+  }
+}
+
+void world_t::refresh_autotile_rows(chunk_t &chunk, int y_begin, int y_end)
+{
+  const int H = autotile_masks_t::HALO;
+  std::array<uint8_t, autotile_masks_t::HALO * autotile_masks_t::HALO> groups{};
+  for (int hy = y_begin; hy <= y_end + 1; hy++)
+  {
+    for (int hx = 0; hx < H; hx++)
+    {
+      // Missing neighbours read as unconnected
+      const tile_definition_t *tile = chunk.get_tile_around(hx - 1, hy - 1);
+      groups[hx + hy * H] = tile ? tile->autotile_group : 0;
+    }
+  }
+
+  chunk.autotile.build(groups.data(), y_begin, y_end);
+  chunk.mesh_dirty = true;
+}
+
 } // namespace deepbound
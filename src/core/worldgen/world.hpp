@@ -1,16 +1,26 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <unordered_map>
 #include <memory>
 #include <future>
+#include <chrono>
+#include <filesystem>
+#include <string>
 #include <glm/glm.hpp>
+#include "core/content/autotile.hpp"
+#include "core/content/liquid_layer.hpp"
+#include "core/content/tile_metadata.hpp"
 
 // Forward declarations
 namespace deepbound
 {
 struct tile_definition_t;
 class chunk_renderer_t;
+class chunk_store_t;
 } // namespace deepbound
 
 namespace deepbound
@@ -38,13 +48,77 @@ struct chunk_t
   // Mesh cache
   std::vector<float> mesh;
   bool mesh_dirty = true;
+  uint64_t mesh_version = 0; // Unique across all chunks, so GPU copies can tell when they're stale
+  uint32_t generator_version = 0; // world_t's generator version this chunk was generated with
+
+  // Saving. Edits through world_t bump edit_version (direct metadata changes call mark_edited());
+  // a save copies it to saved_version, undone if the write fails. Chunks holding player changes are
+  // never regenerated.
+  uint32_t edit_version = 0;
+  uint32_t saved_version = 0;
+  bool from_save = false; // Loaded from the save instead of generated
+
+  void mark_edited()
+  {
+    edit_version++;
+  }
+  bool needs_save() const
+  {
+    return edit_version != saved_version;
+  }
+  bool has_player_changes() const
+  {
+    return from_save || edit_version != 0;
+  }
+
+  // Edge/corner connectivity, kept up to date by world_t (needs neighbouring chunks for the halo)
+  autotile_masks_t autotile;
+
+  // Liquids, apart from the tiles so a cell can hold both. Empty for dry chunks.
+  liquid_layer_t liquids;
+
+  // Local indices of tiles whose behaviours tick, kept up to date by world_t
+  std::vector<uint16_t> ticking_tiles;
+
+  // Sparse per-tile state and block entities, null until a tile needs one
+  std::unique_ptr<chunk_metadata_t> metadata;
+
+  // Pipeline bookkeeping for debug views
+  struct pipeline_stats_t
+  {
+    float generate_ms = 0.0f; // Time inside the generator
+    float wait_ms = 0.0f;     // Request to integration
+    std::chrono::steady_clock::time_point last_visible;
+    uint64_t uploaded_version = 0; // mesh_version last uploaded by the renderer, 0 = never
+    int uploads = 0;
+  } pipeline;
+
+  // world_t's running total of chunk memory once integrated, null before. set_mesh and set_liquid
+  // report size changes to it, so the gauge never has to walk every chunk.
+  size_t *memory_total = nullptr;
+
+  // Approximate bytes held, for the memory gauge
+  size_t memory_bytes() const
+  {
+    return sizeof(chunk_t) + tiles.capacity() * sizeof(tiles[0]) + climate.capacity() * sizeof(climate[0]) + mesh.capacity() * sizeof(float) +
+           liquids.memory_bytes();
+  }
+
+  // Loaded neighbours at (oy + 1) * 3 + (ox + 1), the centre is this chunk. world_t links them when
+  // a chunk is integrated and clears them when one is unloaded, so they never dangle.
+  std::array<chunk_t *, 9> neighbours = {};
 
   chunk_t()
   {
+    neighbours[4] = this;
     tiles.resize(SIZE * SIZE, nullptr);
     climate.resize(SIZE * SIZE);
   }
 
+  // Pinned: neighbours (and other chunks' links) point at this object
+  chunk_t(const chunk_t &) = delete;
+  chunk_t &operator=(const chunk_t &) = delete;
+
   const tile_definition_t *get_tile(int local_x, int local_y) const
   {
     if (local_x < 0 || local_x >= SIZE || local_y < 0 || local_y >= SIZE)
@@ -58,6 +132,130 @@ struct chunk_t
       return;
     tiles[local_x * SIZE + local_y] = tile;
     mesh_dirty = true;
+
+    // A new tile starts fresh
+    if (metadata)
+    {
+      metadata->states.erase((uint16_t)(local_x * SIZE + local_y));
+      metadata->entities.erase((uint16_t)(local_x * SIZE + local_y));
+      release_metadata_if_empty();
+    }
+  }
+
+  tile_state_t get_tile_state(int local_x, int local_y) const
+  {
+    if (!metadata || local_x < 0 || local_x >= SIZE || local_y < 0 || local_y >= SIZE)
+      return {};
+    const tile_state_t *state = metadata->states.find((uint16_t)(local_x * SIZE + local_y));
+    return state ? *state : tile_state_t{};
+  }
+
+  // Storing the default state removes the entry
+  void set_tile_state(int local_x, int local_y, const tile_state_t &state)
+  {
+    if (local_x < 0 || local_x >= SIZE || local_y < 0 || local_y >= SIZE)
+      return;
+    if (state.is_default())
+    {
+      if (metadata)
+      {
+        metadata->states.erase((uint16_t)(local_x * SIZE + local_y));
+        release_metadata_if_empty();
+      }
+      return;
+    }
+    if (!metadata)
+      metadata = std::make_unique<chunk_metadata_t>();
+    metadata->states.get_or_insert((uint16_t)(local_x * SIZE + local_y)) = state;
+  }
+
+  // Null if there is none or it isn't a T
+  template <typename T>
+  T *get_block_entity(int local_x, int local_y) const
+  {
+    if (!metadata || local_x < 0 || local_x >= SIZE || local_y < 0 || local_y >= SIZE)
+      return nullptr;
+    auto *entity = metadata->entities.find((uint16_t)(local_x * SIZE + local_y));
+    return entity ? dynamic_cast<T *>(entity->get()) : nullptr;
+  }
+
+  // Replaces any existing entity on the tile
+  template <typename T, typename... Args>
+  T *emplace_block_entity(int local_x, int local_y, Args &&...args)
+  {
+    if (local_x < 0 || local_x >= SIZE || local_y < 0 || local_y >= SIZE)
+      return nullptr;
+    if (!metadata)
+      metadata = std::make_unique<chunk_metadata_t>();
+    auto entity = std::make_unique<T>(std::forward<Args>(args)...);
+    T *raw = entity.get();
+    metadata->entities.get_or_insert((uint16_t)(local_x * SIZE + local_y)) = std::move(entity);
+    return raw;
+  }
+
+  void remove_block_entity(int local_x, int local_y)
+  {
+    if (!metadata || local_x < 0 || local_x >= SIZE || local_y < 0 || local_y >= SIZE)
+      return;
+    metadata->entities.erase((uint16_t)(local_x * SIZE + local_y));
+    release_metadata_if_empty();
+  }
+
+  void release_metadata_if_empty()
+  {
+    if (metadata && metadata->empty())
+      metadata.reset();
+  }
+
+  chunk_t *get_neighbour(int ox, int oy) const
+  {
+    return neighbours[(oy + 1) * 3 + (ox + 1)];
+  }
+
+  // The chunk holding local (x, y), which may reach up to one chunk past any edge; x and y are made
+  // local to it. Null if that chunk isn't loaded.
+  chunk_t *get_neighbour_at(int &local_x, int &local_y) const
+  {
+    int ox = (local_x < 0) ? -1 : (local_x >= SIZE ? 1 : 0);
+    int oy = (local_y < 0) ? -1 : (local_y >= SIZE ? 1 : 0);
+    local_x -= ox * SIZE;
+    local_y -= oy * SIZE;
+    return get_neighbour(ox, oy);
+  }
+
+  // Like get_tile, but coordinates may reach up to one chunk past any edge. Null if that chunk
+  // isn't loaded.
+  const tile_definition_t *get_tile_around(int local_x, int local_y) const
+  {
+    const chunk_t *c = get_neighbour_at(local_x, local_y);
+    return c ? c->get_tile(local_x, local_y) : nullptr;
+  }
+
+  // Same for liquids; empty if that chunk isn't loaded
+  liquid_cell_t get_liquid_around(int local_x, int local_y) const
+  {
+    const chunk_t *c = get_neighbour_at(local_x, local_y);
+    return c ? c->get_liquid(local_x, local_y) : liquid_cell_t{};
+  }
+
+  liquid_cell_t get_liquid(int local_x, int local_y) const
+  {
+    return liquids.get(local_x, local_y);
+  }
+
+  void set_liquid(int local_x, int local_y, liquid_cell_t cell)
+  {
+    const size_t before = liquids.memory_bytes();
+    const bool was_empty = liquids.get(local_x, local_y).empty();
+    liquids.set(local_x, local_y, cell);
+    mesh_dirty = true;
+    if (memory_total)
+      *memory_total += liquids.memory_bytes() - before;
+
+    // The chunk below draws its top row of liquid full height when this row holds liquid
+    chunk_t *below = local_y == 0 ? get_neighbour(0, -1) : nullptr;
+    if (below && was_empty != cell.empty())
+      below->mesh_dirty = true;
   }
 
   climate_info_t get_climate(int local_x, int local_y) const
@@ -81,8 +279,13 @@ struct chunk_t
   }
   void set_mesh(std::vector<float> new_mesh)
   {
+    static std::atomic<uint64_t> next_version{0};
+    const size_t before = mesh.capacity();
     mesh = std::move(new_mesh);
+    if (memory_total)
+      *memory_total += (mesh.capacity() - before) * sizeof(float);
     mesh_dirty = false;
+    mesh_version = ++next_version;
   }
   const std::vector<float> &get_mesh() const
   {
@@ -103,10 +306,13 @@ struct chunk_t
   } // Same.
 };
 
+static_assert(autotile_masks_t::SIZE == chunk_t::SIZE, "Autotile rows are one bit per chunk column");
+static_assert(liquid_layer_t::SIZE == chunk_t::SIZE, "One liquid layer covers one chunk");
+
 class world_t
 {
 public:
-  world_t();
+  world_t(int seed = 0); // 0 = configured or random
   ~world_t();
 
   void update(double delta_time);
@@ -115,30 +321,164 @@ public:
   const tile_definition_t *get_tile_at(float world_x, float world_y) const;
   const tile_definition_t *get_tile_at(int x, int y) const;
 
+  // Edits a loaded chunk and refreshes autotile masks around the tile. The tile and its neighbours
+  // get a neighbour-changed update (see tile_behavior.hpp) on the next update(). A solid tile pushes
+  // the liquid in its cell out to open neighbours. False if not loaded, if they can't take all of
+  // it, or for liquid definitions (those go through set_liquid_at).
+  bool set_tile_at(int x, int y, const tile_definition_t *tile);
+
+  // Whether the chunk holding the tile is loaded
+  bool is_tile_loaded(int x, int y) const;
+
+  // Liquid layer access. Setting wakes the liquid simulation around the tile. False if not loaded.
+  liquid_cell_t get_liquid_at(int x, int y) const;
+  bool set_liquid_at(int x, int y, liquid_cell_t cell);
+
   // Helper
   bool is_solid(float x, float y) const;
 
+  int get_seed() const;
+
+  // Worldgen hot reload: polls the worldgen configs about once a second. A file whose contents
+  // changed is reloaded on a clone of the generator (only that part, plus dependents), then loaded
+  // chunks are regenerated nearest-first in the background. Stale chunks stay until replaced.
+  void set_watch_config(bool watch)
+  {
+    watch_config = watch;
+  }
+
+  // Saving: chunks with edits are written to region files under `directory` by a throttled
+  // background autosave (and when unloaded), and chunks found there load instead of generating.
+  // The directory remembers the seed; false if it was saved with a different one.
+  bool enable_saving(const std::string &directory, double autosave_interval = 30.0);
+  // Writes every chunk with unsaved edits and waits until it is on disk. Also run on destruction.
+  void save_all();
+  const chunk_store_t *get_chunk_store() const
+  {
+    return store.get();
+  }
+
+  // Request-to-integration time of every chunk generated since the last call
+  std::vector<double> take_chunk_latencies_ms();
+
   // Chunk management
   // For now, let's just generate everything around the camera or 0,0
   std::vector<chunk_t *> get_visible_chunks(const glm::vec2 &camera_pos, int view_distance);
 
   // Get chunk at chunk coords
   chunk_t *get_chunk(int cx, int cy);
+  // Saves it if edited and unlinks it from its neighbours. update() does this for chunks far
+  // outside the last get_visible_chunks view.
+  void unload_chunk(int cx, int cy);
+
+  // Where a chunk is in the load pipeline, for debug views. Doesn't request anything.
+  enum class chunk_load_state_e
+  {
+    none,
+    requested, // Queued, generator not started yet
+    generating,
+    loaded
+  };
+  chunk_load_state_e get_chunk_load_state(int cx, int cy) const;
+  const chunk_t *find_loaded_chunk(int cx, int cy) const
+  {
+    return find_chunk(cx, cy);
+  }
+  size_t get_loaded_chunk_count() const
+  {
+    return chunks.size();
+  }
+  size_t get_pending_chunk_count() const
+  {
+    return pending_chunks.size();
+  }
 
 private:
   std::unordered_map<long long, std::unique_ptr<chunk_t>> chunks;
+  size_t chunk_memory_bytes = 0; // Sum of memory_bytes() over chunks, see chunk_t::memory_total
 
   long long get_chunk_key(int cx, int cy) const
   {
     return ((long long)cx << 32) | (unsigned int)cy;
   }
 
-  // The Generator
-  std::unique_ptr<class world_generator_t> generator;
+  // The Generator. Shared with in-flight generation tasks, so a reload can swap it at any time.
+  std::shared_ptr<class world_generator_t> generator;
+  uint32_t generator_version = 1;
+
+  // Hot reload
+  struct config_file_t
+  {
+    std::string path;
+    std::filesystem::file_time_type modified;
+    uint64_t hash = 0;
+  };
+  std::vector<config_file_t> config_files; // In load order, see world.cpp
+  bool watch_config = false;
+  bool regenerating = false; // Some chunks may be from an older generator
+  double config_check_timer = 0.0;
+  int focus_cx = 0; // Camera chunk from the last get_visible_chunks, regeneration starts here
+  int focus_cy = 0;
+  int focus_view_distance = -1; // -1 until get_visible_chunks runs; nothing is unloaded before that
+  void check_config_changes();
+  void schedule_regeneration();
+
+  // Starts loading or generating a chunk on a worker with the current generator
+  void request_chunk(long long key, int cx, int cy);
+
+  // Saving
+  std::shared_ptr<chunk_store_t> store; // Shared with loading tasks
+  double autosave_interval = 30.0;
+  double autosave_timer = 0.0;
+  std::vector<long long> save_queue; // Autosave work left, spread over frames
+  void update_autosave(double delta_time);
+  void save_chunk(chunk_t &chunk);
+  // Failed writes: loaded chunks are marked unsaved again for autosave, unloaded ones rewritten
+  void retry_failed_saves();
 
   // Async Loading
   std::unordered_map<long long, std::future<std::unique_ptr<chunk_t>>> pending_chunks;
+  struct pending_info_t
+  {
+    std::chrono::steady_clock::time_point since;
+    std::shared_ptr<std::atomic<bool>> started; // Set by the generator task
+  };
+  std::unordered_map<long long, pending_info_t> pending_info;
+  std::vector<double> chunk_latencies_ms;
   void update_chunks();
+  void update_unloading();
+
+  // Tile behaviours: neighbour-changed updates queued by edits, and ticks at a fixed rate
+  struct tile_update_t
+  {
+    int x;
+    int y;
+  };
+  std::vector<tile_update_t> tile_updates;
+  double tile_tick_timer = 0.0;
+  void update_tiles(double delta_time);
+  void queue_tile_updates(int x, int y);
+
+  // Liquid flow: fixed-rate steps over awake sections only (see liquid_layer_t)
+  double liquid_timer = 0.0;
+  int liquid_step = 0;
+  void update_liquids(double delta_time);
+  void step_liquid(chunk_t &chunk, int lx, int ly);
+  // Moves up to `amount` from a cell of `from` to (tx, ty), local to `from` and up to one chunk past
+  // its edges. Returns how much moved. Neighbours are reached through chunk links, no lookups.
+  int flow_liquid(chunk_t &from, int lx, int ly, int tx, int ty, int amount);
+  // Moves all liquid out of a cell about to get a solid tile; false (nothing moved) if it can't
+  bool displace_liquid(chunk_t &chunk, int lx, int ly);
+  void wake_liquids(chunk_t &chunk, int lx, int ly); // Sections of the tile and its neighbours
+
+  // Adds a finished chunk: links neighbours both ways and refreshes autotiling around it
+  chunk_t *integrate_chunk(long long key, std::unique_ptr<chunk_t> chunk);
+
+  // Rebuilds autotile rows of `chunk` and its neighbours for tiles next to the local rect
+  // [lx0, lx1] x [ly0, ly1] (inclusive)
+  void refresh_autotile(chunk_t &chunk, int lx0, int ly0, int lx1, int ly1);
+  void refresh_autotile_rows(chunk_t &chunk, int y_begin, int y_end);
+  chunk_t *find_chunk(int cx, int cy) const;
 };
 
 } // namespace deepbound
@@ -2,12 +2,15 @@
 #include "core/worldgen/world.hpp"
 #include "core/content/tile.hpp"
 #include "core/assets/asset_manager.hpp"
+#include "core/worldgen/coord_hash.hpp"
+#include "core/common/metrics.hpp"
 #include <fstream>
 #include <iostream>
 #include <cmath>
 #include <algorithm>
 #include <random>
 #include <ctime>
+#include <iomanip>
 
 namespace deepbound
 {
@@ -60,8 +63,8 @@ void world_generator_t::load_config(const std::string &path)
   if (j.contains("continental_noise"))
   {
     auto &cn = j["continental_noise"];
-    // Check for global seed if not already set, or override
-    if (j["global"].contains("seed"))
+    // A seed set from code (replays, tools) wins over the config
+    if (global_seed <= 0 && j["global"].contains("seed"))
     {
       global_seed = j["global"].value("seed", 0);
     }
@@ -79,76 +82,62 @@ void world_generator_t::load_config(const std::string &path)
       std::cout << "Using Configured Seed: " << global_seed << std::endl;
     }
 
-    int seed = global_seed; // Use global seed
-    float frequency = cn.value("frequency", 0.0005f);
-    int octaves = cn.value("octaves", 4);
-    float lacunarity = cn.value("lacunarity", 2.0f);
-    float gain = cn.value("gain", 0.5f);
+    // Column signals only vary along X, so they use the 1D kernel
+    column_noise_t::settings_t settings;
+    settings.frequency = cn.value("frequency", 0.0005f);
+    settings.octaves = cn.value("octaves", 4);
+    settings.lacunarity = cn.value("lacunarity", 2.0f);
+    settings.gain = cn.value("gain", 0.5f);
 
-    auto signal = FastNoise::New<FastNoise::Simplex>();
-    auto fractal = FastNoise::New<FastNoise::FractalFBm>();
-    fractal->SetSource(signal);
-    fractal->SetOctaveCount(octaves);
-    fractal->SetGain(gain);
-    fractal->SetLacunarity(lacunarity);
-
-    auto scale = FastNoise::New<FastNoise::DomainScale>();
-    scale->SetSource(fractal);
-    scale->SetScale(frequency);
-
-    continental_noise = scale;
+    continental_noise = column_noise_t(settings);
   }
 
   // Climate Noise Setup (Temp)
   {
-    auto signal = FastNoise::New<FastNoise::Simplex>();
-    auto fractal = FastNoise::New<FastNoise::FractalFBm>();
-    fractal->SetSource(signal);
-    fractal->SetOctaveCount(3);
-    fractal->SetGain(0.5f);
-    fractal->SetLacunarity(2.0f);
-
-    auto scale = FastNoise::New<FastNoise::DomainScale>();
-    scale->SetSource(fractal);
-    scale->SetScale(0.0001f); // Very slow variation for climate
-
-    temp_noise = scale;
+    column_noise_t::settings_t settings;
+    settings.frequency = 0.0001f; // Very slow variation for climate
+    settings.octaves = 3;
+    temp_noise = column_noise_t(settings);
   }
 
   // Climate Noise Setup (Rain)
   {
-    auto signal = FastNoise::New<FastNoise::Simplex>();
-    auto fractal = FastNoise::New<FastNoise::FractalFBm>();
-    fractal->SetSource(signal);
-    fractal->SetOctaveCount(3);
-    fractal->SetGain(0.5f);
-    fractal->SetLacunarity(2.0f);
-
-    auto scale = FastNoise::New<FastNoise::DomainScale>();
-    scale->SetSource(fractal);
-    scale->SetScale(0.00012f); // Slightly different scale
-
-    rain_noise = scale;
+    column_noise_t::settings_t settings;
+    settings.frequency = 0.00012f; // Slightly different scale
+    settings.octaves = 3;
+    rain_noise = column_noise_t(settings);
   }
 
   // Initialize overhang noise (3D Simplex for structures)
   {
+    float frequency = 0.02f; // Medium frequency for overhangs/caves
+    int octaves = 3;
+    if (j.contains("overhang"))
+    {
+      auto &o = j["overhang"];
+      frequency = o.value("frequency", 0.02f);
+      octaves = o.value("octaves", 3);
+      overhang_warp = o.value("warp", 0.0f); // Uses the domain warp stage from caves.json
+    }
+
     auto signal = FastNoise::New<FastNoise::Simplex>();
     // We want distinct structures, so standard fractal
     auto fractal = FastNoise::New<FastNoise::FractalFBm>();
     fractal->SetSource(signal);
-    fractal->SetOctaveCount(3);
+    fractal->SetOctaveCount(octaves);
     fractal->SetGain(0.5f);
     fractal->SetLacunarity(2.0f);
 
     auto scale = FastNoise::New<FastNoise::DomainScale>();
     scale->SetSource(fractal);
-    scale->SetScale(0.02f); // Medium frequency for overhangs/caves
+    scale->SetScale(frequency);
 
-    overhang_noise = scale;
+    overhang_noise = read_noise_graph(j.value("overhang", nlohmann::json::object()), "landforms/overhang", scale);
   }
 
   // Landforms
+  landforms.clear();
+  landform_noises.clear();
   if (j.contains("landforms"))
   {
     for (const auto &l : j["landforms"])
@@ -170,31 +159,107 @@ void world_generator_t::load_config(const std::string &path)
         lf.noise.amplitude = n.value("amplitude", 1.0f);
         lf.noise.seed = global_seed + (int)landforms.size() + 100; // Offset seed for landforms
 
-        auto signal = FastNoise::New<FastNoise::Simplex>();
-        auto fractal = FastNoise::New<FastNoise::FractalFBm>();
-        fractal->SetSource(signal);
-        fractal->SetOctaveCount(lf.noise.octaves);
-        fractal->SetGain(lf.noise.gain);
-        fractal->SetLacunarity(lf.noise.lacunarity);
-
-        auto scale = FastNoise::New<FastNoise::DomainScale>();
-        scale->SetSource(fractal);
-        scale->SetScale(lf.noise.frequency);
-
-        landform_noises.push_back(scale);
+        column_noise_t::settings_t settings;
+        settings.frequency = lf.noise.frequency;
+        settings.octaves = lf.noise.octaves;
+        settings.lacunarity = lf.noise.lacunarity;
+        settings.gain = lf.noise.gain;
+        landform_noises.push_back(column_noise_t(settings));
       }
       else
       {
-        landform_noises.push_back(nullptr);
+        landform_noises.push_back(column_noise_t());
       }
 
       landforms.push_back(lf);
     }
   }
 
+  // Terrain Shaping Splines (replace the landform blend when enabled)
+  terrain_shaping = TerrainShaping{};
+  if (j.contains("terrain_shaping"))
+  {
+    auto &ts = j["terrain_shaping"];
+    terrain_shaping.enabled = ts.value("enabled", false);
+    terrain_shaping.resolution = ts.value("resolution", 1024);
+    terrain_shaping.secondary_resolution = ts.value("secondary_resolution", 64);
+
+    // Seeds here are offsets from the world seed, applied when sampling
+    auto read_noise = [](const nlohmann::json &n, NoiseConfig &cfg, float frequency, int octaves, int seed)
+    {
+      cfg.frequency = n.value("frequency", frequency);
+      cfg.octaves = n.value("octaves", octaves);
+      cfg.lacunarity = n.value("lacunarity", 2.0f);
+      cfg.gain = n.value("gain", 0.5f);
+      cfg.amplitude = n.value("amplitude", 1.0f);
+      cfg.seed = seed;
+
+      column_noise_t::settings_t settings;
+      settings.frequency = cfg.frequency;
+      settings.octaves = cfg.octaves;
+      settings.lacunarity = cfg.lacunarity;
+      settings.gain = cfg.gain;
+      return column_noise_t(settings);
+    };
+
+    terrain_secondary_noise = read_noise(ts.value("secondary_noise", nlohmann::json::object()), terrain_shaping.secondary_noise, 0.0008f, 3, 2024);
+    terrain_detail_noise = read_noise(ts.value("detail_noise", nlohmann::json::object()), terrain_shaping.detail_noise, 0.004f, 4, 2025);
+
+    if (ts.contains("height"))
+      terrain_shaping.height = terrain_spline_t::from_json(ts["height"]);
+    if (ts.contains("variance"))
+      terrain_shaping.variance = terrain_spline_t::from_json(ts["variance"]);
+    if (ts.contains("overhang"))
+      terrain_shaping.overhang = terrain_spline_t::from_json(ts["overhang"]);
+
+    // Bake once here; chunk generation only does table lookups
+    terrain_shaping.height.bake(terrain_shaping.resolution, terrain_shaping.secondary_resolution);
+    terrain_shaping.variance.bake(terrain_shaping.resolution, terrain_shaping.secondary_resolution);
+    terrain_shaping.overhang.bake(terrain_shaping.resolution, terrain_shaping.secondary_resolution);
+
+    if (terrain_shaping.enabled && terrain_shaping.height.empty())
+    {
+      std::cerr << "Warning: Terrain shaping enabled without a height spline, falling back to landforms." << std::endl;
+      terrain_shaping.enabled = false;
+    }
+  }
+
+  // Optional Heightmap Erosion
+  surface_erosion_t::settings_t erosion_settings;
+  if (j.contains("erosion"))
+  {
+    auto &e = j["erosion"];
+    erosion_settings.enabled = e.value("enabled", false);
+    erosion_settings.region_width = e.value("region_width", 512);
+    erosion_settings.overlap = e.value("overlap", 128);
+    erosion_settings.thermal_iterations = e.value("thermal_iterations", 40);
+    erosion_settings.talus = e.value("talus", 1.5f);
+    erosion_settings.thermal_rate = e.value("thermal_rate", 0.5f);
+    erosion_settings.hydraulic_iterations = e.value("hydraulic_iterations", 30);
+    erosion_settings.rain = e.value("rain", 0.02f);
+    erosion_settings.capacity = e.value("capacity", 4.0f);
+    erosion_settings.erosion_rate = e.value("erosion_rate", 0.3f);
+    erosion_settings.deposition_rate = e.value("deposition_rate", 0.3f);
+    erosion_settings.evaporation = e.value("evaporation", 0.05f);
+  }
+  configure_erosion(erosion_settings);
+
   std::cout << "World Generator Config Loaded. " << landforms.size() << " landforms." << std::endl;
 }
 
+void world_generator_t::configure_erosion(const surface_erosion_t::settings_t &settings)
+{
+  erosion.configure(settings, [this](int x_start, int count, float *out) { sample_surface_columns(global_seed, x_start, count, 1, out, nullptr); });
+}
+
+std::unique_ptr<world_generator_t> world_generator_t::clone() const
+{
+  auto copy = std::make_unique<world_generator_t>(*this);
+  // The erosion sampler points back at its generator; the region caches start over
+  copy->configure_erosion(erosion.get_settings());
+  return copy;
+}
+
 void world_generator_t::load_caves(const std::string &path)
 {
   std::ifstream file(path);
@@ -207,17 +272,67 @@ void world_generator_t::load_caves(const std::string &path)
   nlohmann::json j;
   file >> j;
 
+  // Reloads start from the defaults, like the first load
+  cave_config = CaveConfig{};
+  domain_warp = DomainWarpConfig{};
+
   if (j.contains("global_min_depth"))
   {
     cave_config.global_min_depth = j["global_min_depth"];
   }
 
+  // Domain Warp Stage (shared by caves and overhangs)
+  if (j.contains("domain_warp"))
+  {
+    auto &w = j["domain_warp"];
+    domain_warp.enabled = w.value("enabled", false);
+    domain_warp.amplitude = w.value("amplitude", 30.0f);
+    domain_warp.frequency = w.value("frequency", 0.01f);
+    domain_warp.octaves = w.value("octaves", 2);
+    domain_warp.gain = w.value("gain", 0.5f);
+    domain_warp.lacunarity = w.value("lacunarity", 2.0f);
+    domain_warp.seed = global_seed + 700;
+
+    if (domain_warp.enabled)
+    {
+      // FastNoise2 warps the input position of its source; warping a position output
+      // returns the warped coordinate itself, one node per axis.
+      auto make_warped_axis = [&](bool y_axis) -> FastNoise::SmartNode<>
+      {
+        auto position = FastNoise::New<FastNoise::PositionOutput>();
+        if (y_axis)
+          position->Set<FastNoise::Dim::Y>(1.0f);
+        else
+          position->Set<FastNoise::Dim::X>(1.0f);
+
+        auto warp = FastNoise::New<FastNoise::DomainWarpGradient>();
+        warp->SetSource(position);
+        warp->SetWarpAmplitude(domain_warp.amplitude);
+        warp->SetWarpFrequency(domain_warp.frequency);
+
+        if (domain_warp.octaves <= 1)
+          return warp;
+
+        auto fractal = FastNoise::New<FastNoise::DomainWarpFractalProgressive>();
+        fractal->SetSource(warp);
+        fractal->SetOctaveCount(domain_warp.octaves);
+        fractal->SetGain(domain_warp.gain);
+        fractal->SetLacunarity(domain_warp.lacunarity);
+        return fractal;
+      };
+
+      warp_x_noise = make_warped_axis(false);
+      warp_y_noise = make_warped_axis(true);
+    }
+  }
+
   if (j.contains("cheese_caves"))
   {
     auto &c = j["cheese_caves"];
     cave_config.cheese_enabled = c.value("enabled", false);
     cave_config.cheese_threshold = c.value("threshold", 0.5f);
     cave_config.cheese_fade_depth = c.value("surface_fade_depth", 30.0f);
+    cave_config.cheese_warp = c.value("warp", 0.0f);
 
     cave_config.cheese_noise.frequency = c.value("frequency", 0.015f);
     cave_config.cheese_noise.octaves = c.value("octaves", 2);
@@ -238,7 +353,7 @@ void world_generator_t::load_caves(const std::string &path)
       scale->SetSource(fractal);
       scale->SetScale(cave_config.cheese_noise.frequency);
 
-      cheese_noise = scale;
+      cheese_noise = read_noise_graph(c, "caves/cheese", scale);
     }
   }
 
@@ -249,6 +364,7 @@ void world_generator_t::load_caves(const std::string &path)
     cave_config.worm_thickness = c.value("thickness", 0.08f);
     cave_config.worm_thickness_variation = c.value("thickness_variation", 0.0f);
     cave_config.worm_fade_depth = c.value("surface_fade_depth", 40.0f);
+    cave_config.worm_warp = c.value("warp", 0.0f);
 
     cave_config.worm_noise.frequency = c.value("frequency", 0.02f);
     cave_config.worm_noise.octaves = c.value("octaves", 1);
@@ -270,7 +386,7 @@ void world_generator_t::load_caves(const std::string &path)
       scale->SetSource(fractal);
       scale->SetScale(cave_config.worm_noise.frequency);
 
-      worm_noise = scale;
+      worm_noise = read_noise_graph(c, "caves/worm", scale);
     }
   }
 
@@ -293,6 +409,7 @@ void world_generator_t::load_provinces(const std::string &path)
   if (j.contains("provinces"))
   {
     provinces.clear();
+    province_layer_noise_count = 0;
     for (const auto &p : j["provinces"])
     {
       GeologicalProvince prov;
@@ -315,11 +432,53 @@ void world_generator_t::load_provinces(const std::string &path)
           layer.type = l.value("type", "blob"); // blob, layer
           layer.frequency = l.value("frequency", 0.05f);
           layer.threshold = l.value("threshold", 0.6f);
+          layer.min_depth = l.value("min_depth", 0);
+          layer.max_depth = l.value("max_depth", 1 << 30);
           layer.resolved_tile = deepbound::tile_registry_t::get().get_tile(resource_id_t("deepbound", layer.tile_code));
 
           if (!layer.resolved_tile)
             std::cout << "Warning: Could not resolve mix tile '" << layer.tile_code << "' for province '" << prov.name << "'" << std::endl;
 
+          // Resolve type once instead of comparing strings per tile
+          if (layer.type == "blob")
+            layer.kind = province_layer_type_e::blob;
+          else if (layer.type == "layer" || layer.type == "strata")
+            layer.kind = province_layer_type_e::strata;
+          else if (layer.type == "vein")
+            layer.kind = province_layer_type_e::vein;
+          else if (layer.type == "dyke")
+            layer.kind = province_layer_type_e::dyke;
+          else if (layer.type == "crust")
+            layer.kind = province_layer_type_e::crust;
+          else
+            std::cout << "Warning: Unknown layer type '" << layer.type << "' for province '" << prov.name << "'" << std::endl;
+
+          // Crust reuses frequency as its depth scale (0.1 = 10 tiles)
+          if (layer.kind == province_layer_type_e::crust)
+            layer.max_depth = std::min(layer.max_depth, (int)(layer.frequency * 100.0f) - 1);
+
+          // Every noise-driven layer gets its own seeded source so layers don't move together.
+          // Blobs scale with the layer frequency; other types use it for band spacing or depth.
+          if (layer.kind != province_layer_type_e::strata && layer.kind != province_layer_type_e::unknown)
+          {
+            float noise_frequency = l.value("noise_frequency", layer.kind == province_layer_type_e::blob ? layer.frequency : 0.05f);
+
+            auto signal = FastNoise::New<FastNoise::Simplex>();
+            auto fractal = FastNoise::New<FastNoise::FractalFBm>();
+            fractal->SetSource(signal);
+            fractal->SetOctaveCount(2);
+            fractal->SetGain(0.5f);
+            fractal->SetLacunarity(2.0f);
+
+            auto scale = FastNoise::New<FastNoise::DomainScale>();
+            scale->SetSource(fractal);
+            scale->SetScale(noise_frequency);
+
+            layer.noise = read_noise_graph(l, "provinces/" + prov.name + "/" + std::to_string(prov.layers.size()), scale);
+            layer.noise_seed = (int)hash_coords((int)provinces.size(), (int)prov.layers.size(), global_seed + 777);
+            layer.noise_slot = province_layer_noise_count++;
+          }
+
           prov.layers.push_back(layer);
         }
       }
@@ -337,6 +496,17 @@ void world_generator_t::load_provinces(const std::string &path)
     seed_offset = j["noise"].value("seed_offset", 9999);
   }
 
+  // Voronoi Cell Layout
+  province_map_t::settings_t cell_settings;
+  if (j.contains("cells"))
+  {
+    auto &c = j["cells"];
+    cell_settings.cell_size = c.value("size", 256);
+    cell_settings.jitter = c.value("jitter", 0.8f);
+    cell_settings.region_cells = c.value("region_cells", 8);
+    province_boundary_warp = c.value("boundary_warp", 24.0f);
+  }
+
   auto signal = FastNoise::New<FastNoise::Simplex>();
   auto fractal = FastNoise::New<FastNoise::FractalFBm>();
   fractal->SetSource(signal);
@@ -348,25 +518,133 @@ void world_generator_t::load_provinces(const std::string &path)
   scale->SetSource(fractal);
   scale->SetScale(frequency);
 
-  province_noise = scale;
+  province_noise = read_noise_graph(j.value("noise", nlohmann::json::object()), "provinces/selector", scale);
+  province_map.configure(cell_settings, (int)provinces.size(), province_noise, global_seed + seed_offset);
+
+  std::cout << "Province Config Loaded. " << provinces.size() << " provinces." << std::endl;
+}
 
-  // Mix Noise (3D Simplex High Freq)
+void world_generator_t::load_aquifers(const std::string &path)
+{
+  std::ifstream file(path);
+  if (!file.is_open())
   {
-    auto m_signal = FastNoise::New<FastNoise::Simplex>();
-    auto m_fractal = FastNoise::New<FastNoise::FractalFBm>();
-    m_fractal->SetSource(m_signal);
-    m_fractal->SetOctaveCount(2);
-    m_fractal->SetGain(0.5f);
-    m_fractal->SetLacunarity(2.0f);
-
-    auto m_scale = FastNoise::New<FastNoise::DomainScale>();
-    m_scale->SetSource(m_fractal);
-    m_scale->SetScale(0.05f); // Default mix scale
-
-    province_mix_noise = m_scale;
+    std::cerr << "Failed to open aquifer config: " << path << std::endl;
+    return;
   }
 
-  std::cout << "Province Config Loaded. " << provinces.size() << " provinces." << std::endl;
+  nlohmann::json j;
+  file >> j;
+
+  aquifer_map_t::settings_t settings;
+  settings.enabled = j.value("enabled", false);
+  settings.cell_size = j.value("cell_size", 16);
+  settings.region_cells = j.value("region_cells", 16);
+  settings.fill_chance = j.value("fill_chance", 0.3f);
+  settings.level_jitter = j.value("level_jitter", 0.75f);
+  settings.min_depth = j.value("min_depth", 30);
+
+  aquifer_tiles.clear();
+  if (j.contains("fluids"))
+  {
+    for (const auto &f : j["fluids"])
+    {
+      std::string code = f.value("tile", "water");
+      const tile_definition_t *tile = deepbound::tile_registry_t::get().get_tile(resource_id_t("deepbound", code));
+      if (!tile)
+      {
+        std::cout << "Warning: Could not resolve aquifer fluid tile '" << code << "'" << std::endl;
+        continue;
+      }
+
+      aquifer_map_t::fluid_t fluid;
+      fluid.max_y = f.value("max_y", 1 << 30);
+      settings.fluids.push_back(fluid);
+      aquifer_tiles.push_back(tile);
+    }
+  }
+
+  aquifer_map.configure(settings, global_seed + 4242);
+
+  std::cout << "Aquifer Config Loaded. " << aquifer_tiles.size() << " fluids." << std::endl;
+}
+
+void world_generator_t::load_ores(const std::string &path)
+{
+  std::ifstream file(path);
+  if (!file.is_open())
+  {
+    std::cerr << "Failed to open ore config: " << path << std::endl;
+    return;
+  }
+
+  nlohmann::json j;
+  file >> j;
+
+  ore_body_map_t::settings_t settings;
+  settings.region_size = j.value("region_size", 256);
+
+  // [min, max] pair or a single value
+  auto read_range = [](const nlohmann::json &o, const char *key, auto &min_v, auto &max_v)
+  {
+    if (!o.contains(key))
+      return;
+    if (o[key].is_array() && o[key].size() >= 2)
+    {
+      o[key][0].get_to(min_v);
+      o[key][1].get_to(max_v);
+    }
+    else if (o[key].is_number())
+    {
+      o[key].get_to(min_v);
+      max_v = min_v;
+    }
+  };
+
+  ores.clear();
+  if (j.contains("ores"))
+  {
+    for (const auto &o : j["ores"])
+    {
+      OreConfig ore;
+      ore.name = o.value("name", "Unknown");
+      ore.tile_code = o.value("tile", "rock-granite");
+      ore.resolved_tile = deepbound::tile_registry_t::get().get_tile(resource_id_t("deepbound", ore.tile_code));
+      if (!ore.resolved_tile)
+      {
+        std::cout << "Warning: Could not resolve ore tile '" << ore.tile_code << "' for ore '" << ore.name << "'" << std::endl;
+        continue;
+      }
+      read_range(o, "depth", ore.min_depth, ore.max_depth);
+
+      if (o.contains("provinces"))
+      {
+        ore.allowed_provinces.assign(provinces.size(), 0);
+        for (const auto &name : o["provinces"])
+        {
+          auto it = std::find_if(provinces.begin(), provinces.end(), [&](const GeologicalProvince &p) { return p.name == name.get<std::string>(); });
+          if (it != provinces.end())
+            ore.allowed_provinces[it - provinces.begin()] = 1;
+          else
+            std::cout << "Warning: Unknown province '" << name.get<std::string>() << "' for ore '" << ore.name << "'" << std::endl;
+        }
+      }
+
+      ore_body_map_t::ore_t body;
+      body.shape = (o.value("shape", "blob") == "vein") ? ore_shape_e::vein : ore_shape_e::blob;
+      body.spacing = o.value("spacing", 96.0f);
+      body.chance = o.value("chance", 1.0f);
+      read_range(o, "size", body.min_size, body.max_size);
+      read_range(o, "thickness", body.min_thickness, body.max_thickness);
+
+      ores.push_back(ore);
+      settings.ores.push_back(body);
+    }
+  }
+
+  ore_bodies.configure(settings, global_seed + 31337);
+
+  std::cout << "Ore Config Loaded. " << ores.size() << " ores." << std::endl;
 }
 
 void world_generator_t::load_block_layers(const std::string &path)
@@ -481,14 +759,17 @@ void world_generator_t::load_block_layers(const std::string &path)
   scale->SetSource(fractal);
   scale->SetScale(0.02f); // Low frequency for long, smooth variations
 
-  strata_noise = scale;
+  strata_noise = read_noise_graph(j.value("strata_noise", nlohmann::json::object()), "blocklayers/strata", scale);
 }
 
 // Optimization: Batch noise generation
 // Optimization: Batch noise generation + Column Caching + Loop Interchange
 void world_generator_t::generate_chunk(chunk_t *chunk, int chunk_x, int chunk_y)
 {
-  if (landforms.empty())
+  static auto &generate_seconds = metrics_t::get().histogram("deepbound_worldgen_chunk_seconds", "Time to generate one chunk", metrics_t::seconds_buckets());
+  metric_timer_t timer(generate_seconds);
+
+  if (landforms.empty() && !terrain_shaping.enabled)
     return;
 
   // Constants
@@ -501,11 +782,8 @@ void world_generator_t::generate_chunk(chunk_t *chunk, int chunk_x, int chunk_y)
   std::vector<float> overhang_map_buf(SIZE * SIZE);
   std::vector<float> cheese_map_buf(SIZE * SIZE);
   std::vector<float> worm_map_buf(SIZE * SIZE);
-  std::vector<float> province_map_buf(SIZE * SIZE);
-  std::vector<float> province_mix_map_buf(SIZE * SIZE);
   std::vector<float> strata_map_buf(SIZE * SIZE);
 
-  std::vector<float> continental_map_buf(SIZE);
   std::vector<float> temp_map_buf(SIZE);
   std::vector<float> rain_map_buf(SIZE);
 
@@ -513,110 +791,145 @@ void world_generator_t::generate_chunk(chunk_t *chunk, int chunk_x, int chunk_y)
   std::vector<float> cached_overhang_strength(SIZE);
   std::vector<std::pair<float, float>> cached_climate(SIZE);
   std::vector<const BlockLayer *> cached_active_layer(SIZE);
+  std::vector<uint8_t> province_idx_buf(SIZE * SIZE, 0);
 
   // 2. Generate Column Data (Stateless) --------------------------------------
 
   // Generate Column Noise
-  if (continental_noise)
-    continental_noise->GenUniformGrid2D(continental_map_buf.data(), global_x_start, 0, SIZE, 1, 1.0f, global_seed);
+  sample_surface_columns(global_seed, global_x_start, SIZE, 1, cached_surface_height.data(), cached_overhang_strength.data());
+  erosion.get_heights(global_x_start, SIZE, cached_surface_height.data());
 
-  if (temp_noise)
-    temp_noise->GenUniformGrid2D(temp_map_buf.data(), global_x_start, 0, SIZE, 1, 1.0f, global_seed + 999);
+  if (temp_noise.is_configured())
+    temp_noise.generate(global_x_start, SIZE, 1, global_seed + 999, temp_map_buf.data());
 
-  if (rain_noise)
-    rain_noise->GenUniformGrid2D(rain_map_buf.data(), global_x_start, 0, SIZE, 1, 1.0f, global_seed + 888);
+  if (rain_noise.is_configured())
+    rain_noise.generate(global_x_start, SIZE, 1, global_seed + 888, rain_map_buf.data());
 
-  // Derive Surface Height & Climate
+  // Derive Climate
   for (int x = 0; x < SIZE; x++)
   {
-    int global_x = global_x_start + x;
-    float cont_val = continental_map_buf[x];
+    // Climate
+    float climate_t = temp_map_buf[x] * 30.0f + 10.0f;
+    float climate_r = (rain_map_buf[x] + 1.0f) * 0.5f * 255.0f;
+    cached_climate[x] = {climate_t, climate_r};
 
-    // Find landforms
-    size_t i1 = 0, i2 = 0;
-    float lf_t = 0.0f;
+    // Active Layer (Pre-calculate!)
+    int layer_idx = select_block_layer(climate_t, climate_r);
+    cached_active_layer[x] = (layer_idx >= 0) ? &block_layers[layer_idx] : nullptr;
+  }
 
-    if (cont_val <= landforms[0].threshold)
+  // 3. Generate Chunk Maps (Batched) -----------------------------------------
+
+  // Domain warp offsets are generated once and shared by every map that opts in
+  std::vector<float> warp_dx, warp_dy, warp_px, warp_py;
+  if (warp_x_noise && warp_y_noise)
+  {
+    bool wanted = (overhang_noise && overhang_warp > 0.0f) || (cave_config.cheese_enabled && cave_config.cheese_warp > 0.0f) ||
+                  (cave_config.worm_enabled && cave_config.worm_warp > 0.0f);
+    if (wanted)
     {
-      i1 = i2 = 0;
-      lf_t = 0;
+      warp_dx.resize(SIZE * SIZE);
+      warp_dy.resize(SIZE * SIZE);
+      warp_px.resize(SIZE * SIZE);
+      warp_py.resize(SIZE * SIZE);
+      sample_warp_offsets(global_x_start, global_y_start, SIZE, SIZE, warp_dx.data(), warp_dy.data());
     }
-    else if (cont_val >= landforms.back().threshold)
+  }
+
+  auto gen_map = [&](const FastNoise::SmartNode<> &noise, float *out, float warp_strength, int seed)
+  {
+    if (warp_dx.empty() || warp_strength <= 0.0f)
     {
-      i1 = i2 = landforms.size() - 1;
-      lf_t = 0;
+      noise->GenUniformGrid2D(out, global_x_start, global_y_start, SIZE, SIZE, 1.0f, seed);
+      return;
     }
-    else
+    for (int y = 0; y < SIZE; y++)
     {
-      for (size_t i = 0; i < landforms.size() - 1; i++)
+      for (int x = 0; x < SIZE; x++)
       {
-        if (cont_val >= landforms[i].threshold && cont_val < landforms[i + 1].threshold)
-        {
-          i1 = i;
-          i2 = i + 1;
-          float range = landforms[i2].threshold - landforms[i1].threshold;
-          lf_t = (range > 0.0001f) ? (cont_val - landforms[i1].threshold) / range : 0;
-          break;
-        }
+        int i = x + y * SIZE;
+        warp_px[i] = (float)(global_x_start + x) + warp_dx[i] * warp_strength;
+        warp_py[i] = (float)(global_y_start + y) + warp_dy[i] * warp_strength;
       }
     }
+    noise->GenPositionArray2D(out, SIZE * SIZE, warp_px.data(), warp_py.data(), 0.0f, 0.0f, seed);
+  };
 
-    // Height (Still scalar unfortunately for landforms, but fast enough)
-    auto get_lf_h_local = [&](size_t idx)
-    {
-      const auto &lf = landforms[idx];
-      float nv = 0.0f;
-      if (idx < landform_noises.size() && landform_noises[idx])
-        nv = landform_noises[idx]->GenSingle2D(global_x, 0, global_seed + 1337 + idx);
-      return lf.base_height + (nv * lf.height_variance);
-    };
+  if (overhang_noise)
+    gen_map(overhang_noise, overhang_map_buf.data(), overhang_warp, global_seed + 12345);
 
-    float h1 = get_lf_h_local(i1);
-    float h2 = (i1 == i2) ? h1 : get_lf_h_local(i2);
-    cached_surface_height[x] = h1 + (h2 - h1) * lf_t;
+  if (cave_config.cheese_enabled && cheese_noise)
+    gen_map(cheese_noise, cheese_map_buf.data(), cave_config.cheese_warp, cave_config.cheese_noise.seed);
 
-    // Overhang Strength
-    cached_overhang_strength[x] = landforms[i1].overhang_strength * (1.0f - lf_t) + landforms[i2].overhang_strength * lf_t;
+  if (cave_config.worm_enabled && worm_noise)
+    gen_map(worm_noise, worm_map_buf.data(), cave_config.worm_warp, cave_config.worm_noise.seed);
 
-    // Climate
-    float climate_t = temp_map_buf[x] * 30.0f + 10.0f;
-    float climate_r = (rain_map_buf[x] + 1.0f) * 0.5f * 255.0f;
-    cached_climate[x] = {climate_t, climate_r};
+  if (strata_noise)
+    strata_noise->GenUniformGrid2D(strata_map_buf.data(), global_x_start, global_y_start, SIZE, SIZE, 1.0f, global_seed + 111);
 
-    // Active Layer (Pre-calculate!)
-    const BlockLayer *active_layer = nullptr;
-    for (const auto &layer : block_layers)
+  // Province Assignment: resolve the few Voronoi sites around this chunk once, then a
+  // nearest-site test per tile. Strata noise displaces the lookup to roughen cell edges.
+  if (!provinces.empty() && province_map.is_configured())
+  {
+    std::vector<province_map_t::site_t> sites;
+    province_map.resolve_sites((float)global_x_start - province_boundary_warp, (float)global_y_start - province_boundary_warp, (float)(global_x_start + SIZE - 1) + province_boundary_warp,
+                               (float)(global_y_start + SIZE - 1) + province_boundary_warp, sites);
+
+    std::vector<float> query_x(SIZE * SIZE);
+    std::vector<float> query_y(SIZE * SIZE);
+    for (int y = 0; y < SIZE; y++)
     {
-      if (climate_t >= layer.min_temp && climate_t <= layer.max_temp && climate_r >= layer.min_rain && climate_r <= layer.max_rain)
+      for (int x = 0; x < SIZE; x++)
       {
-        active_layer = &layer;
-        break;
+        int buf_idx = x + y * SIZE;
+        float warp = strata_noise ? strata_map_buf[buf_idx] * province_boundary_warp : 0.0f;
+        query_x[buf_idx] = (float)(global_x_start + x) + warp;
+        query_y[buf_idx] = (float)(global_y_start + y) - warp;
       }
     }
-    if (!active_layer && !block_layers.empty())
-      active_layer = &block_layers[0];
-    cached_active_layer[x] = active_layer;
+    province_map_t::assign_nearest(sites, query_x.data(), query_y.data(), SIZE * SIZE, province_idx_buf.data());
   }
 
-  // 3. Generate Chunk Maps (Batched) -----------------------------------------
-
-  if (overhang_noise)
-    overhang_noise->GenUniformGrid2D(overhang_map_buf.data(), global_x_start, global_y_start, SIZE, SIZE, 1.0f, global_seed + 12345);
-
-  if (cave_config.cheese_enabled && cheese_noise)
-    cheese_noise->GenUniformGrid2D(cheese_map_buf.data(), global_x_start, global_y_start, SIZE, SIZE, 1.0f, cave_config.cheese_noise.seed);
-
-  if (cave_config.worm_enabled && worm_noise)
-    worm_noise->GenUniformGrid2D(worm_map_buf.data(), global_x_start, global_y_start, SIZE, SIZE, 1.0f, cave_config.worm_noise.seed);
-
-  if (!provinces.empty() && province_noise)
-    province_noise->GenUniformGrid2D(province_map_buf.data(), global_x_start, global_y_start, SIZE, SIZE, 1.0f, global_seed + 9999);
+  // Ore bodies overlapping this chunk, stamped once. Depth and province are checked while
+  // stamping, so a body an ore can't host here leaves an earlier ore's body in place.
+  std::vector<uint8_t> ore_buf;
+  if (ore_bodies.is_configured())
+  {
+    ore_buf.assign(SIZE * SIZE, 0);
+    ore_bodies.stamp(global_x_start, global_y_start, SIZE, SIZE, ore_buf.data(),
+                     [&](int ore_idx, int gx, int gy)
+                     {
+                       const auto &ore = ores[ore_idx];
+                       const int buf_idx = (gx - global_x_start) + (gy - global_y_start) * SIZE;
+                       int depth = std::max(0, (int)(cached_surface_height[gx - global_x_start] - (float)gy));
+                       if (depth < ore.min_depth || depth > ore.max_depth)
+                         return false;
+                       int p_idx = provinces.empty() ? 0 : std::min((int)province_idx_buf[buf_idx], (int)provinces.size() - 1);
+                       return ore.allowed_provinces.empty() || (p_idx < (int)ore.allowed_provinces.size() && ore.allowed_provinces[p_idx]);
+                     });
+  }
 
-  if (province_mix_noise)
-    province_mix_noise->GenUniformGrid2D(province_mix_map_buf.data(), global_x_start, global_y_start, SIZE, SIZE, 1.0f, global_seed + 777);
+  // Aquifer cells around this chunk (a handful of cached lookups)
+  aquifer_map_t::window_t aquifer_window;
+  if (aquifer_map.is_enabled())
+    aquifer_window = aquifer_map.get_window(global_x_start, global_y_start, global_x_start + SIZE - 1, global_y_start + SIZE - 1);
+  const float aquifer_min_depth = (float)aquifer_map.get_settings().min_depth;
 
-  if (strata_noise)
-    strata_noise->GenUniformGrid2D(strata_map_buf.data(), global_x_start, global_y_start, SIZE, SIZE, 1.0f, global_seed + 111);
+  // Province layer noise is filled on first use, so layers whose province is absent from this
+  // chunk, or whose depth range is never reached, cost nothing.
+  std::vector<std::vector<float>> layer_noise_bufs(province_layer_noise_count);
+  auto get_layer_noise = [&](const ProvinceLayer &layer, int buf_idx) -> float
+  {
+    if (!layer.noise)
+      return 0.0f;
+    auto &buf = layer_noise_bufs[layer.noise_slot];
+    if (buf.empty())
+    {
+      buf.resize(SIZE * SIZE);
+      layer.noise->GenUniformGrid2D(buf.data(), global_x_start, global_y_start, SIZE, SIZE, 1.0f, layer.noise_seed);
+    }
+    return buf[buf_idx];
+  };
 
   // 4. Process Chunk using Cached Data (Y-Outer Loop Optimization) -----------
   // Iterate Y first to access noise buffers linearly (row by row)
@@ -638,11 +951,10 @@ void world_generator_t::generate_chunk(chunk_t *chunk, int chunk_x, int chunk_y)
       float noise_overhang_val = overhang_map_buf[buf_idx];
       float noise_cheese_val = cheese_map_buf[buf_idx];
       float noise_worm_val = worm_map_buf[buf_idx];
-      float noise_province_val = province_map_buf[buf_idx];
-      float noise_mix_val = province_mix_map_buf[buf_idx];
       float noise_strata_val = strata_map_buf[buf_idx];
 
       const tile_definition_t *tile = air_tile;
+      const tile_definition_t *liquid = nullptr; // Goes to the liquid layer, the tile stays air
 
       // 1. Calculate Base Density
       float base_density = surface_height - (float)global_y;
@@ -747,103 +1059,65 @@ void world_generator_t::generate_chunk(chunk_t *chunk, int chunk_x, int chunk_y)
         const tile_definition_t *deep_stone = stone_tile;
         if (!provinces.empty())
         {
-          float pv = noise_province_val;
-          // Distortion
-          if (strata_noise)
-            pv += noise_strata_val * 0.15f;
-
-          float norm = (pv + 1.0f) * 0.5f;
-          norm = std::max(0.0f, std::min(0.99f, norm));
-          int p_idx = (int)(norm * provinces.size());
+          int p_idx = std::min((int)province_idx_buf[buf_idx], (int)provinces.size() - 1);
 
           // Use CACHED tile
           if (provinces[p_idx].resolved_tile)
             deep_stone = provinces[p_idx].resolved_tile;
 
-          // Check Mixtures/Layers
+          // Check Mixtures/Layers. Later layers take priority, so scan from the back and stop
+          // at the first match; layer noise is only generated once a tile actually needs it.
           const auto &prov = provinces[p_idx];
-          for (const auto &layer : prov.layers)
+          for (auto it = prov.layers.rbegin(); it != prov.layers.rend(); ++it)
           {
-            if (!layer.resolved_tile)
+            const auto &layer = *it;
+            if (!layer.resolved_tile || depth < layer.min_depth || depth > layer.max_depth)
               continue;
 
             bool applies = false;
-            if (layer.type == "blob")
+            switch (layer.kind)
             {
-              // Use mix noise (3D-ish, but here projected 2D from same buffer? No, GenUniformGrid2D generates XY plane)
-              // We effectively have 2D noise in the buffer.
-              // For TRUE 3D blobs we need distinct Y sampling or a 3D buffer.
-              // Current architecture generates 2D buffers per chunk (which is 2D vertical slice? No, chunk_t is 32x32?)
-              // Chunk is likely 32x32 blocks?
-              // Wait, check generate_chunk signature: chunk_x, chunk_y.
-              // If this is a side-view 2D game (Terraria-like), then X and Y are world coordinates.
-              // The GenUniformGrid2D is called with (global_x_start, global_y_start).
-              // So "province_mix_map_buf" DOES contain unique noise for this X,Y block.
-              // So noise_mix_val IS effectively coherent 2D noise for this pixel. Perfect.
-
-              // However, we might want different seeds for different layers?
-              // For simplicity, we stick to one master mix noise for now, using thresholds.
-              // Or we could offset the value based on layer index: sin(val + index) etc.
-
-              // Simple Threshold:
-              float n = noise_mix_val;
-              // To avoid all layers appearing in same spot, offset noise by layer index
-              // Cheap offset:
-              n = std::fmod(n + (float)(&layer - &prov.layers[0]) * 0.31f, 1.0f);
-              if (n > layer.threshold)
-                applies = true;
-            }
-            else if (layer.type == "layer" || layer.type == "strata")
+            case province_layer_type_e::blob:
+              applies = get_layer_noise(layer, buf_idx) > layer.threshold;
+              break;
+            case province_layer_type_e::strata:
             {
-              // Y-dependent mixing.
-              // Use strata noise (low freq) + local Y
-              // A layer typically appears at certain depths or repeating intervals.
-              // Let's do repeating intervals for "banding"
-              // band = sin(y * freq + noise)
+              // Repeating horizontal bands, offset by low frequency strata noise
               float band = std::sin((float)global_y * 0.1f * layer.frequency + noise_strata_val * 4.0f);
-              if (band > layer.threshold)
-                applies = true;
+              applies = band > layer.threshold;
+              break;
             }
-            else if (layer.type == "vein") // Rare veins
+            case province_layer_type_e::vein: // Rare veins
             {
-              float n = std::sin(noise_mix_val * 10.0f + (float)global_y * 0.1f);
-              if (n > layer.threshold + 0.2f)
-                applies = true;
+              float n = std::sin(get_layer_noise(layer, buf_idx) * 10.0f + (float)global_y * 0.1f);
+              applies = n > layer.threshold + 0.2f;
+              break;
             }
-            else if (layer.type == "dyke") // Vertical intrusions
+            case province_layer_type_e::dyke: // Vertical intrusions
             {
-              // X-dependent noise. We need to create vertical bands.
-              // Band = sin(x * freq + noise)
-              // Use noise_mix_val (which is xy) to distort the bands so they aren't perfect lines.
-              float band = std::sin((float)global_x * 0.1f * layer.frequency + noise_mix_val * 2.0f);
-              // Sharp threshold for dykes
-              if (band > layer.threshold)
-                applies = true;
+              // Vertical bands along X, distorted by the layer noise so they aren't perfect lines
+              float band = std::sin((float)global_x * 0.1f * layer.frequency + get_layer_noise(layer, buf_idx) * 2.0f);
+              applies = band > layer.threshold;
+              break;
             }
-            else if (layer.type == "crust") // Surface coating
-            {
-              // Depth dependent
-              if (depth < (int)(layer.frequency * 100.0f)) // Reuse frequency as depth scale (0.1 = 10 blocks, etc.)
-              {
-                // Optional noise breakup
-                if (noise_mix_val > layer.threshold)
-                  applies = true;
-              }
+            case province_layer_type_e::crust: // Surface coating (depth limit applied above)
+              applies = get_layer_noise(layer, buf_idx) > layer.threshold;
+              break;
+            default:
+              break;
             }
 
             if (applies)
             {
               deep_stone = layer.resolved_tile;
-              // Don't break? Or break?
-              // If we don't break, subsequent layers generate "on top".
-              // Let's break to keep it simple order-based priority.
-              // break;
-              // Actually, "layers" should probably override "blobs"?
-              // If we iterate array order, last one wins.
+              break;
             }
           }
         }
 
+        if (!ore_buf.empty() && ore_buf[buf_idx])
+          deep_stone = ores[ore_buf[buf_idx] - 1].resolved_tile;
+
         tile = deep_stone;
 
         if (active_layer && !active_layer->entries.empty())
@@ -904,16 +1178,22 @@ void world_generator_t::generate_chunk(chunk_t *chunk, int chunk_x, int chunk_y)
       else
       {
         // Air/Water
-        if (global_y < sea_level)
+        if (global_y < sea_level && base_density <= 0.0f)
         {
-          if (base_density <= 0.0f)
-            tile = water_tile;
-          else
-            tile = air_tile;
+          liquid = water_tile;
+        }
+        else if (base_density > 0.0f && surface_height - (float)global_y >= aquifer_min_depth)
+        {
+          // Carved cave: flood it up to the local aquifer level
+          uint8_t fluid = aquifer_window.fluid_at(global_x, global_y);
+          if (fluid)
+            liquid = aquifer_tiles[fluid - 1];
         }
       }
 
       chunk->set_tile(x, y, tile);
+      if (liquid)
+        chunk->set_liquid(x, y, {liquid->runtime_id, 255});
       // chunk->set_climate(x, y, climate_t, climate_r); // Climate is not Y-dependent, so we can access cached
       chunk->set_climate(x, y, cached_climate[x].first, cached_climate[x].second);
     }
@@ -940,8 +1220,10 @@ float world_generator_t::get_base_density(int x, int y, float surface_height, fl
 
   if (overhang_strength > 0.001f && overhang_noise)
   {
-    // 3D noise sample.
-    float noise = overhang_noise->GenSingle2D(x * 1.0f, y * 1.5f, global_seed + 12345);
+    // Same sample position as the chunk buffer, so chunk edges agree with their interior
+    float wx, wy;
+    warp_point((float)x, (float)y, overhang_warp, wx, wy);
+    float noise = overhang_noise->GenSingle2D(wx, wy, global_seed + 12345);
 
     // Equation: surface_height + noise * strength > y
     density = (surface_height - (float)y) + (noise * overhang_strength * 40.0f); // 40.0 arbitrary scale factor for noise amp
@@ -961,8 +1243,9 @@ float world_generator_t::get_cave_density_modifier(int x, int y, float surface_h
   // 1. Cheese Caves (Large open areas)
   if (cave_config.cheese_enabled && cheese_noise)
   {
-    // Use 3D noise (x, y, seed)
-    float n = cheese_noise->GenSingle2D(x * 1.0f, y * 1.0f, cave_config.cheese_noise.seed);
+    float wx, wy;
+    warp_point((float)x, (float)y, cave_config.cheese_warp, wx, wy);
+    float n = cheese_noise->GenSingle2D(wx, wy, cave_config.cheese_noise.seed);
 
     // Fade in near surface
     float fade = 1.0f;
@@ -985,7 +1268,9 @@ float world_generator_t::get_cave_density_modifier(int x, int y, float surface_h
   // 2. Worm Caves (Tunnels)
   if (cave_config.worm_enabled && worm_noise)
   {
-    float n = worm_noise->GenSingle2D(x * 1.0f, y * 1.0f, cave_config.worm_noise.seed);
+    float wx, wy;
+    warp_point((float)x, (float)y, cave_config.worm_warp, wx, wy);
+    float n = worm_noise->GenSingle2D(wx, wy, cave_config.worm_noise.seed);
     // Ridged noise: -1 to 1. Val close to 1 is "ridge" usually? Or 0?
     // Standard ridged: 1 - abs(noise). Peaks are at 0 (or 1 depending on impl).
     // FastNoise FractalRidged usually returns peaks at 1.0.
@@ -1022,82 +1307,241 @@ std::pair<float, float> world_generator_t::get_climate_at(int x)
   float t = 0.0f;
   float r = 128.0f;
 
-  if (temp_noise)
+  if (temp_noise.is_configured())
   {
-    float val = temp_noise->GenSingle2D(x, 0, global_seed + 999); // Seed for temp
+    float val = temp_noise.single(x, global_seed + 999); // Seed for temp
     t = val * 30.0f + 10.0f;                                      // -20 to 40 approx
   }
 
-  if (rain_noise)
+  if (rain_noise.is_configured())
   {
-    float val = rain_noise->GenSingle2D(x, 0, global_seed + 888); // Seed for rain
+    float val = rain_noise.single(x, global_seed + 888); // Seed for rain
     r = (val + 1.0f) * 0.5f * 255.0f;                             // 0 to 255
   }
 
   return {t, r};
 }
 
-float world_generator_t::get_height_at(int x)
+FastNoise::SmartNode<> world_generator_t::read_noise_graph(const nlohmann::json &block, const std::string &label, FastNoise::SmartNode<> fallback)
+{
+  NoiseGraphEntry entry{label, block.value("budget_ns", 0.0f), {}};
+  if (block.contains("graph"))
+  {
+    std::string error;
+    if (!entry.graph.compile(block["graph"], error))
+      std::cout << "Warning: Noise graph '" << label << "': " << error << ". Using built-in noise." << std::endl;
+  }
+  if (entry.graph.empty())
+  {
+    if (!fallback)
+      return fallback;
+    entry.graph.assign(fallback, "Built-in");
+  }
+
+  // Reloading a config replaces its entries
+  std::erase_if(noise_graphs, [&](const NoiseGraphEntry &e) { return e.label == label; });
+  noise_graphs.push_back(entry);
+  return entry.graph.get_root();
+}
+
+bool world_generator_t::profile_noise_graphs(int grid_size)
+{
+  bool within_budget = true;
+  std::cout << "Noise profile (" << grid_size << "x" << grid_size << " grid, ns/sample):" << std::endl;
+  for (const auto &entry : noise_graphs)
+  {
+    auto nodes = entry.graph.profile(grid_size);
+    if (nodes.empty())
+      continue;
+
+    bool over = entry.budget_ns > 0.0f && nodes[0].total_ns > entry.budget_ns;
+    within_budget = within_budget && !over;
+    std::cout << "  " << std::left << std::setw(40) << entry.label << std::right << std::fixed << std::setprecision(2) << std::setw(9) << nodes[0].total_ns;
+    if (entry.budget_ns > 0.0f)
+      std::cout << " / " << entry.budget_ns << (over ? "  OVER BUDGET" : "");
+    std::cout << std::endl;
+
+    if (nodes.size() > 1)
+    {
+      for (const auto &n : nodes)
+        std::cout << "    " << std::string(n.depth * 2, ' ') << std::left << std::setw(36 - n.depth * 2) << n.name << std::right << std::setw(9) << n.self_ns << " self" << std::endl;
+    }
+  }
+  std::cout << std::defaultfloat;
+  return within_budget;
+}
+
+int world_generator_t::select_block_layer(float temperature, float rainfall) const
 {
-  if (landforms.empty())
-    return (float)sea_level;
+  for (size_t i = 0; i < block_layers.size(); i++)
+  {
+    const auto &layer = block_layers[i];
+    if (temperature >= layer.min_temp && temperature <= layer.max_temp && rainfall >= layer.min_rain && rainfall <= layer.max_rain)
+      return (int)i;
+  }
+  return block_layers.empty() ? -1 : 0;
+}
 
-  float cont_val = 0.0f;
-  if (continental_noise)
-    cont_val = continental_noise->GenSingle2D(x, 0, global_seed);
+void world_generator_t::sample_columns(int seed, int x_start, int count, int step, ColumnSample *out)
+{
+  step = std::max(step, 1);
 
-  // Find the two landforms to blend between
-  size_t i1 = 0;
-  size_t i2 = 0;
-  float t = 0.0f;
+  std::vector<float> height(count), temp(count, 0.0f), rain(count, 0.0f);
+  sample_surface_columns(seed, x_start, count, step, height.data(), nullptr);
 
-  if (cont_val <= landforms[0].threshold)
+  if (temp_noise.is_configured())
+    temp_noise.generate(x_start, count, step, seed + 999, temp.data());
+  if (rain_noise.is_configured())
+    rain_noise.generate(x_start, count, step, seed + 888, rain.data());
+
+  for (int i = 0; i < count; i++)
   {
-    i1 = i2 = 0;
-    t = 0.0f;
+    out[i].height = height[i];
+    out[i].temperature = temp[i] * 30.0f + 10.0f;
+    out[i].rainfall = (rain[i] + 1.0f) * 0.5f * 255.0f;
+    out[i].block_layer = select_block_layer(out[i].temperature, out[i].rainfall);
   }
-  else if (cont_val >= landforms.back().threshold)
+}
+
+void world_generator_t::sample_surface_columns(int seed, int x_start, int count, int step, float *out_height, float *out_overhang)
+{
+  if (landforms.empty() && !terrain_shaping.enabled)
   {
-    i1 = i2 = landforms.size() - 1;
-    t = 0.0f;
+    std::fill(out_height, out_height + count, (float)sea_level);
+    if (out_overhang)
+      std::fill(out_overhang, out_overhang + count, 0.0f);
+    return;
   }
-  else
+
+  // Columns x_start + i * step
+  step = std::max(step, 1);
+
+  std::vector<float> continental(count, 0.0f);
+  if (continental_noise.is_configured())
+    continental_noise.generate(x_start, count, step, seed, continental.data());
+
+  // Spline path: three batched noise rows, then branch-free LUT lookups
+  if (terrain_shaping.enabled)
   {
-    for (size_t i = 0; i < landforms.size() - 1; i++)
+    std::vector<float> secondary(count, 0.0f);
+    std::vector<float> detail(count, 0.0f);
+    std::vector<float> variance(count);
+    if (terrain_secondary_noise.is_configured())
+      terrain_secondary_noise.generate(x_start, count, step, seed + terrain_shaping.secondary_noise.seed, secondary.data());
+    if (terrain_detail_noise.is_configured())
+      terrain_detail_noise.generate(x_start, count, step, seed + terrain_shaping.detail_noise.seed, detail.data());
+
+    terrain_shaping.height.sample(continental.data(), secondary.data(), count, out_height);
+    terrain_shaping.variance.sample(continental.data(), secondary.data(), count, variance.data());
+    for (int x = 0; x < count; x++)
+      out_height[x] += detail[x] * terrain_shaping.detail_noise.amplitude * variance[x];
+
+    if (out_overhang)
+      terrain_shaping.overhang.sample(continental.data(), secondary.data(), count, out_overhang);
+    return;
+  }
+
+  // Find the two landforms to blend between, per column
+  std::vector<int> lf_a(count), lf_b(count);
+  std::vector<float> lf_t(count, 0.0f);
+  std::vector<char> needed(landforms.size(), 0);
+
+  for (int x = 0; x < count; x++)
+  {
+    float cont_val = continental[x];
+    size_t i1 = 0, i2 = 0;
+    float t = 0.0f;
+
+    if (cont_val <= landforms[0].threshold)
     {
-      if (cont_val >= landforms[i].threshold && cont_val < landforms[i + 1].threshold)
+      i1 = i2 = 0;
+    }
+    else if (cont_val >= landforms.back().threshold)
+    {
+      i1 = i2 = landforms.size() - 1;
+    }
+    else
+    {
+      for (size_t i = 0; i < landforms.size() - 1; i++)
       {
-        i1 = i;
-        i2 = i + 1;
-        float range = landforms[i2].threshold - landforms[i1].threshold;
-        if (range > 0.0001f)
-          t = (cont_val - landforms[i1].threshold) / range;
-        else
-          t = 0.0f;
-        break;
+        if (cont_val >= landforms[i].threshold && cont_val < landforms[i + 1].threshold)
+        {
+          i1 = i;
+          i2 = i + 1;
+          float range = landforms[i2].threshold - landforms[i1].threshold;
+          t = (range > 0.0001f) ? (cont_val - landforms[i1].threshold) / range : 0.0f;
+          break;
+        }
       }
     }
+
+    lf_a[x] = (int)i1;
+    lf_b[x] = (int)i2;
+    lf_t[x] = t;
+    needed[i1] = needed[i2] = 1;
+  }
+
+  // Landform noise, batched over the span and only for landforms present in it
+  std::vector<std::vector<float>> lf_noise(landforms.size());
+  for (size_t idx = 0; idx < landforms.size(); idx++)
+  {
+    if (!needed[idx] || idx >= landform_noises.size() || !landform_noises[idx].is_configured())
+      continue;
+    lf_noise[idx].resize(count);
+    landform_noises[idx].generate(x_start, count, step, seed + 1337 + (int)idx, lf_noise[idx].data());
   }
 
-  auto get_lf_height = [&](size_t idx)
+  auto get_lf_height = [&](int idx, int x)
   {
     const auto &lf = landforms[idx];
-    float noise_val = 0.0f;
-    if (idx < landform_noises.size() && landform_noises[idx])
-      noise_val = landform_noises[idx]->GenSingle2D(x, 0, global_seed + 1337 + idx);
-    return lf.base_height + (noise_val * lf.height_variance);
+    float nv = lf_noise[idx].empty() ? 0.0f : lf_noise[idx][x];
+    return lf.base_height + (nv * lf.height_variance);
   };
 
-  if (i1 == i2)
+  for (int x = 0; x < count; x++)
   {
-    return get_lf_height(i1);
+    float h1 = get_lf_height(lf_a[x], x);
+    float h2 = (lf_a[x] == lf_b[x]) ? h1 : get_lf_height(lf_b[x], x);
+    out_height[x] = h1 + (h2 - h1) * lf_t[x];
+
+    if (out_overhang)
+      out_overhang[x] = landforms[lf_a[x]].overhang_strength * (1.0f - lf_t[x]) + landforms[lf_b[x]].overhang_strength * lf_t[x];
   }
+}
 
-  float h1 = get_lf_height(i1);
-  float h2 = get_lf_height(i2);
+void world_generator_t::sample_warp_offsets(int x_start, int y_start, int w, int h, float *out_dx, float *out_dy)
+{
+  warp_x_noise->GenUniformGrid2D(out_dx, x_start, y_start, w, h, 1.0f, domain_warp.seed);
+  warp_y_noise->GenUniformGrid2D(out_dy, x_start, y_start, w, h, 1.0f, domain_warp.seed);
 
-  // Linear interpolation for smooth transition
-  return h1 + (h2 - h1) * t;
+  // Keep only the displacement so each consumer can scale it
+  for (int y = 0; y < h; y++)
+  {
+    for (int x = 0; x < w; x++)
+    {
+      out_dx[x + y * w] -= (float)(x_start + x);
+      out_dy[x + y * w] -= (float)(y_start + y);
+    }
+  }
+}
+
+void world_generator_t::warp_point(float x, float y, float strength, float &out_x, float &out_y)
+{
+  out_x = x;
+  out_y = y;
+  if (strength <= 0.0f || !warp_x_noise || !warp_y_noise)
+    return;
+
+  out_x += (warp_x_noise->GenSingle2D(x, y, domain_warp.seed) - x) * strength;
+  out_y += (warp_y_noise->GenSingle2D(x, y, domain_warp.seed) - y) * strength;
+}
+
+float world_generator_t::get_height_at(int x)
+{
+  float height = 0.0f;
+  sample_surface_columns(global_seed, x, 1, 1, &height, nullptr);
+  erosion.get_heights(x, 1, &height);
+  return height;
 }
 
 } // namespace deepbound
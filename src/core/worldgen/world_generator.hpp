@@ -5,6 +5,13 @@
 #include <memory>
 #include <nlohmann/json.hpp>
 #include <FastNoise/FastNoise.h>
+#include "core/worldgen/aquifer_map.hpp"
+#include "core/worldgen/column_noise.hpp"
+#include "core/worldgen/noise_graph.hpp"
+#include "core/worldgen/ore_body_map.hpp"
+#include "core/worldgen/province_map.hpp"
+#include "core/worldgen/surface_erosion.hpp"
+#include "core/worldgen/terrain_spline.hpp"
 
 namespace deepbound
 {
@@ -34,6 +41,20 @@ struct Landform
   NoiseConfig noise;
 };
 
+// Spline-driven alternative to the landform threshold blend.
+// Curves map continental value (x) and a secondary noise value (curve `at`) to surface shape.
+struct TerrainShaping
+{
+  bool enabled = false;
+  int resolution = 1024;          // LUT samples along continental value
+  int secondary_resolution = 64;  // LUT rows along the secondary value (2D splines only)
+  NoiseConfig secondary_noise;    // Picks between curves, e.g. flat vs. rugged coasts
+  NoiseConfig detail_noise;       // Local bumps, scaled by the variance spline
+  terrain_spline_t height;
+  terrain_spline_t variance;
+  terrain_spline_t overhang;
+};
+
 struct BlockLayerEntry
 {
   std::string tile_code;
@@ -51,6 +72,19 @@ struct BlockLayer
   std::vector<BlockLayerEntry> submerged_entries;
 };
 
+// Shared domain warp stage. Consumers sample their noise at position + warp * offset, so the
+// offsets are generated once per chunk no matter how many noises use them.
+struct DomainWarpConfig
+{
+  bool enabled = false;
+  float amplitude = 30.0f;  // Max displacement in tiles
+  float frequency = 0.01f;
+  int octaves = 2;
+  float gain = 0.5f;
+  float lacunarity = 2.0f;
+  int seed = 0;
+};
+
 struct CaveConfig
 {
   // Cheese (Large Caverns)
@@ -58,6 +92,7 @@ struct CaveConfig
   NoiseConfig cheese_noise;
   float cheese_threshold = 0.5f;
   float cheese_fade_depth = 30.0f;
+  float cheese_warp = 0.0f; // Domain warp strength (0 = unwarped)
 
   // Worm (Tunnels)
   bool worm_enabled = false;
@@ -65,17 +100,36 @@ struct CaveConfig
   float worm_thickness = 0.08f;
   float worm_thickness_variation = 0.0f;
   float worm_fade_depth = 40.0f;
+  float worm_warp = 0.0f;
 
   int global_min_depth = 20;
 };
 
+enum class province_layer_type_e
+{
+  unknown,
+  blob,   // Noise threshold
+  strata, // Horizontal bands ("layer" or "strata")
+  vein,   // Thin noise ridges (discrete deposits belong in ores.json)
+  dyke,   // Vertical bands distorted by noise
+  crust   // Near-surface coating
+};
+
 struct ProvinceLayer
 {
   std::string tile_code;
   const tile_definition_t *resolved_tile = nullptr;
   std::string type;        // "blob", "layer", "vein"
+  province_layer_type_e kind = province_layer_type_e::unknown;
   float frequency = 0.05f; // For noise
   float threshold = 0.6f;  // Noise threshold
+  int min_depth = 0;       // Depth range (tiles below surface) where the layer can appear
+  int max_depth = 1 << 30;
+
+  // Own noise source, generated lazily per chunk (null for types that don't need one)
+  FastNoise::SmartNode<> noise;
+  int noise_seed = 0;
+  int noise_slot = -1; // Index into the per-chunk layer noise buffers
 };
 
 struct GeologicalProvince
@@ -86,6 +140,34 @@ struct GeologicalProvince
   std::vector<ProvinceLayer> layers;
 };
 
+// Placement rules for one ore; its shape and spacing live in ore_body_map_t::ore_t
+struct OreConfig
+{
+  std::string name;
+  std::string tile_code;
+  const tile_definition_t *resolved_tile = nullptr;
+  int min_depth = 0; // Tiles below the surface
+  int max_depth = 1 << 30;
+  std::vector<char> allowed_provinces; // Indexed by province; empty = any province
+};
+
+// A 2D noise source as loaded, kept for profiling
+struct NoiseGraphEntry
+{
+  std::string label;  // e.g. "caves/cheese"
+  float budget_ns;    // Per-sample cost limit from "budget_ns", 0 = none
+  noise_graph_t graph;
+};
+
+// Surface-only column sample for tools
+struct ColumnSample
+{
+  float height;      // Un-eroded surface height
+  float temperature; // -50..50
+  float rainfall;    // 0..255
+  int block_layer;   // Index into the block layers, -1 if none are loaded
+};
+
 class world_generator_t
 {
 public:
@@ -96,10 +178,45 @@ public:
   void load_block_layers(const std::string &path);
   void load_caves(const std::string &path);
   void load_provinces(const std::string &path);
+  void load_aquifers(const std::string &path);
+  void load_ores(const std::string &path); // After load_provinces (province names are resolved)
+
+  // Loaders replace what the previous call loaded, so a config can be loaded again on a clone
+  // (hot reload) while the original keeps generating. load_ores must follow load_provinces.
+
+  // Copy sharing the compiled parts, to reload some of them without touching this one
+  std::unique_ptr<world_generator_t> clone() const;
 
   // Main generate function
   void generate_chunk(chunk_t *chunk, int chunk_x, int chunk_y);
 
+  // Fast path for seed search: height and climate for `count` columns spaced `step` tiles apart,
+  // for any seed, without chunks or erosion.
+  void sample_columns(int seed, int x_start, int count, int step, ColumnSample *out);
+
+  // Times every loaded 2D noise (and each node of described graphs) on a reference grid.
+  // Returns false if any noise exceeds its "budget_ns".
+  bool profile_noise_graphs(int grid_size = 128);
+
+  // Before load_config; 0 = use the configured seed or a random one
+  void set_seed(int seed)
+  {
+    global_seed = seed;
+  }
+  int get_seed() const
+  {
+    return global_seed;
+  }
+
+  int get_sea_level() const
+  {
+    return sea_level;
+  }
+  const std::vector<BlockLayer> &get_block_layers() const
+  {
+    return block_layers;
+  }
+
 private:
   world_t *world;
 
@@ -109,24 +226,59 @@ private:
   int global_seed;
 
   // FastNoise2 Generators
-  FastNoise::SmartNode<> continental_noise;
-  FastNoise::SmartNode<> temp_noise;
-  FastNoise::SmartNode<> rain_noise;
+  // Column signals (1D)
+  column_noise_t continental_noise;
+  column_noise_t temp_noise;
+  column_noise_t rain_noise;
 
   FastNoise::SmartNode<> thickness_noise;
   FastNoise::SmartNode<> overhang_noise; // New: 3D noise for overhangs
+  float overhang_warp = 0.0f;            // Domain warp strength for overhang noise
+
+  DomainWarpConfig domain_warp;
+  FastNoise::SmartNode<> warp_x_noise; // Warped X position
+  FastNoise::SmartNode<> warp_y_noise; // Warped Y position
 
   FastNoise::SmartNode<> cheese_noise;
   FastNoise::SmartNode<> worm_noise;
   FastNoise::SmartNode<> strata_noise;       // generic noise for varying layer thickness
-  FastNoise::SmartNode<> province_noise;     // Noise for province selection
-  FastNoise::SmartNode<> province_mix_noise; // Noise for mixing stones within provinces
+  FastNoise::SmartNode<> province_noise;     // Noise for province selection (sampled once per Voronoi cell)
 
-  std::vector<FastNoise::SmartNode<>> landform_noises;
+  std::vector<NoiseGraphEntry> noise_graphs; // Every 2D noise above, by config label
+
+  std::vector<column_noise_t> landform_noises;
   std::vector<Landform> landforms;
+  TerrainShaping terrain_shaping;
+  column_noise_t terrain_secondary_noise;
+  column_noise_t terrain_detail_noise;
   std::vector<BlockLayer> block_layers;
   std::vector<GeologicalProvince> provinces;
+  province_map_t province_map;
+  int province_layer_noise_count = 0; // Number of layers owning a noise source
+  float province_boundary_warp = 24.0f; // Tiles of strata-noise displacement applied to province lookups
   CaveConfig cave_config;
+  aquifer_map_t aquifer_map;
+  std::vector<OreConfig> ores;
+  ore_body_map_t ore_bodies;
+  std::vector<const tile_definition_t *> aquifer_tiles; // Per aquifer fluid index - 1
+  surface_erosion_t erosion;
+
+  // Column pipeline: continental -> shaping splines (or landform blend), batched over `count` columns
+  // spaced `step` tiles apart. Writes un-eroded surface heights; overhang strength is optional.
+  void sample_surface_columns(int seed, int x_start, int count, int step, float *out_height, float *out_overhang);
+
+  void configure_erosion(const surface_erosion_t::settings_t &settings);
+
+  // Noise from a config block's "graph" (encoded or described), else `fallback`. Either way the
+  // result is registered under `label` for profile_noise_graphs().
+  FastNoise::SmartNode<> read_noise_graph(const nlohmann::json &block, const std::string &label, FastNoise::SmartNode<> fallback);
+
+  // Block layer index for a climate, -1 if there are none
+  int select_block_layer(float temperature, float rainfall) const;
+
+  // Domain warp: per-tile offsets for a w*h grid, and the same for a single point
+  void sample_warp_offsets(int x_start, int y_start, int w, int h, float *out_dx, float *out_dy);
+  void warp_point(float x, float y, float strength, float &out_x, float &out_y);
 
   // Helper to get height at x
   float get_height_at(int x);
@@ -3,11 +3,24 @@
 #include "core/content/item.hpp"
 #include "core/content/tile.hpp"
 #include "core/assets/json_loader.hpp"
+#include "core/graphics/chunk_pipeline_overlay.hpp"
 #include "core/graphics/chunk_renderer.hpp"
 #include "core/graphics/window.hpp"
 #include "core/graphics/window.hpp"
 #include "core/worldgen/world.hpp"
+#include "core/common/input_recording.hpp"
+#include "core/common/metrics.hpp"
+#include "core/common/perf_stats.hpp"
+#include "core/common/task_graph.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
 
 // Temporary for glClearColor/glClear without GLEW/GLAD
 #include <GLFW/glfw3.h>
@@ -15,58 +28,227 @@
 #include "backends/imgui_impl_glfw.h"
 #include "backends/imgui_impl_opengl3.h"
 
+namespace
+{
+struct options_t
+{
+  int seed = 0;
+  std::string record_path; // Write the input stream here on exit
+  std::string replay_path; // Play this input stream back as a benchmark, then exit
+  std::string report_path; // Optional JSON copy of the replay report
+  int vram_budget_mb = 256; // Chunk meshes kept on the GPU
+  int metrics_port = 0;      // Serve Prometheus metrics on 127.0.0.1:port
+  std::string metrics_dump;  // Rewrite metrics to this file periodically
+  double metrics_interval = 10.0;
+  std::string save_dir; // Load and autosave edited chunks here
+  bool chunk_textures = false; // Draw chunks from cached textures instead of their meshes
+};
+
+auto parse_options(int argc, char *argv[], options_t &options) -> bool
+{
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    if (i + 1 >= argc)
+    {
+      std::cerr << "Missing value for " << arg << std::endl;
+      return false;
+    }
+
+    if (arg == "--seed")
+      options.seed = std::atoi(argv[++i]);
+    else if (arg == "--record")
+      options.record_path = argv[++i];
+    else if (arg == "--replay")
+      options.replay_path = argv[++i];
+    else if (arg == "--report")
+      options.report_path = argv[++i];
+    else if (arg == "--vram-budget")
+      options.vram_budget_mb = std::max(1, std::atoi(argv[++i]));
+    else if (arg == "--metrics-port")
+      options.metrics_port = std::atoi(argv[++i]);
+    else if (arg == "--metrics-dump")
+      options.metrics_dump = argv[++i];
+    else if (arg == "--metrics-interval")
+      options.metrics_interval = std::atof(argv[++i]);
+    else if (arg == "--save")
+      options.save_dir = argv[++i];
+    else if (arg == "--render-mode")
+    {
+      std::string mode = argv[++i];
+      if (mode != "mesh" && mode != "texture")
+      {
+        std::cerr << "Unknown render mode: " << mode << std::endl;
+        return false;
+      }
+      options.chunk_textures = mode == "texture";
+    }
+    else
+    {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Frame times, hitches and chunk latency of a replay
+auto report_replay(const std::vector<double> &frame_ms, const std::vector<double> &chunk_ms, const std::string &report_path) -> void
+{
+  auto frames = deepbound::summarize(frame_ms);
+  auto chunks = deepbound::summarize(chunk_ms);
+  int hitches_33 = 0;
+  int hitches_100 = 0;
+  for (double ms : frame_ms)
+  {
+    hitches_33 += ms > 33.3 ? 1 : 0;
+    hitches_100 += ms > 100.0 ? 1 : 0;
+  }
+
+  std::cout << "Replay: " << frames.count << " frames" << std::endl;
+  std::cout << "  Frame ms:  mean " << frames.mean << "  p50 " << frames.p50 << "  p90 " << frames.p90 << "  p99 " << frames.p99 << "  max " << frames.max << std::endl;
+  std::cout << "  Hitches:   >33ms " << hitches_33 << "  >100ms " << hitches_100 << std::endl;
+  std::cout << "  Chunk ms:  " << chunks.count << " chunks  mean " << chunks.mean << "  p50 " << chunks.p50 << "  p90 " << chunks.p90 << "  p99 " << chunks.p99 << "  max "
+            << chunks.max << std::endl;
+
+  if (report_path.empty())
+    return;
+
+  auto to_json = [](const deepbound::perf_summary_t &p)
+  { return nlohmann::json{{"count", p.count}, {"mean", p.mean}, {"p50", p.p50}, {"p90", p.p90}, {"p99", p.p99}, {"max", p.max}}; };
+  nlohmann::json j;
+  j["frame_ms"] = to_json(frames);
+  j["chunk_latency_ms"] = to_json(chunks);
+  j["hitches"] = {{"over_33ms", hitches_33}, {"over_100ms", hitches_100}};
+
+  std::ofstream file(report_path);
+  file << j.dump(2) << std::endl;
+}
+} // namespace
+
 int main(int argc, char *argv[])
 {
   std::cout << "Deepbound Game Starting..." << std::endl;
 
+  options_t options;
+  if (!parse_options(argc, argv, options))
+  {
+    std::cout << "Usage: deepbound_game [--seed N] [--save DIR] [--vram-budget MB] [--render-mode mesh|texture] [--record FILE] [--replay FILE [--report FILE]]\n"
+              << "       [--metrics-port PORT] [--metrics-dump FILE [--metrics-interval SECONDS]]" << std::endl;
+    return 1;
+  }
+
+  deepbound::metrics_exporter_t metrics_exporter;
+  if ((options.metrics_port > 0 || !options.metrics_dump.empty()) && !metrics_exporter.start(options.metrics_port, options.metrics_dump, options.metrics_interval))
+    return 1;
+
+  deepbound::input_recording_t recording;
+  const bool replaying = !options.replay_path.empty();
+  if (replaying && !recording.load(options.replay_path))
+    return 1;
+
   deepbound::window_t::properties_t props;
   props.title = "Deepbound";
   props.width = 1280;
   props.height = 720;
-  props.vsync = true;
-
-  deepbound::window_t window(props);
+  props.vsync = !replaying; // Replays measure frame cost, not the display rate
 
-  // Initialize systems
+  // Startup as a dependency graph: content parsing, PNG decoding and worldgen setup run on worker
+  // threads while the window and GL come up; only the atlas upload waits on both.
+  // World generation data is loaded from assets/worldgen/ within the world_generator_t constructor.
   auto &asset_mgr = deepbound::asset_manager_t::get();
-  asset_mgr.initialize();
-
-  // Setup Dear ImGui context
-  IMGUI_CHECKVERSION();
-  ImGui::CreateContext();
-  ImGuiIO &io = ImGui::GetIO();
-  (void)io;
-  io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard; // Enable Keyboard Controls
-  io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;  // Enable Gamepad Controls
-  io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;     // Enable Docking
-
-  // Setup Dear ImGui style
-  ImGui::StyleColorsDark();
-
-  // Setup Platform/Renderer backends
-  ImGui_ImplGlfw_InitForOpenGL(window.get_native_window(), true);
-  ImGui_ImplOpenGL3_Init("#version 330");
+  std::unique_ptr<deepbound::window_t> window_ptr;
+  std::unique_ptr<deepbound::world_t> world_ptr;
+  std::unique_ptr<deepbound::chunk_renderer_t> renderer_ptr;
+  std::vector<deepbound::asset_manager_t::pending_texture_t> decoded_textures;
+
+  using affinity_e = deepbound::task_graph_t::affinity_e;
+  deepbound::task_graph_t startup;
+  startup.add(
+      "window",
+      [&]()
+      {
+        window_ptr = std::make_unique<deepbound::window_t>(props);
+        if (!window_ptr->is_valid())
+          throw std::runtime_error("could not create the window");
+
+        // Initialize systems
+        asset_mgr.initialize();
+
+        // Setup Dear ImGui context
+        IMGUI_CHECKVERSION();
+        ImGui::CreateContext();
+        ImGuiIO &io = ImGui::GetIO();
+        (void)io;
+        io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard; // Enable Keyboard Controls
+        io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;  // Enable Gamepad Controls
+        io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;     // Enable Docking
+
+        // Setup Dear ImGui style
+        ImGui::StyleColorsDark();
+
+        // Setup Platform/Renderer backends
+        ImGui_ImplGlfw_InitForOpenGL(window_ptr->get_native_window(), true);
+        ImGui_ImplOpenGL3_Init("#version 330");
+      },
+      {}, affinity_e::main_thread);
+  startup.add("tiles", []() { deepbound::json_loader_t::load_tiles_from_directory("assets/tiles"); });
+  startup.add("color_maps", []() { deepbound::json_loader_t::load_color_maps("assets/config/color_maps.json"); });
+  startup.add("decode_textures", [&]() { decoded_textures = asset_mgr.decode_textures_from_registry(); }, {"tiles", "color_maps"});
+  startup.add(
+      "upload_textures",
+      [&]()
+      {
+        asset_mgr.upload_textures(decoded_textures);
+        decoded_textures.clear();
+      },
+      {"window", "decode_textures"}, affinity_e::main_thread);
+  startup.add("world", [&]() { world_ptr = std::make_unique<deepbound::world_t>(replaying ? recording.seed : options.seed); }, {"tiles"});
+  startup.add("renderer", [&]() { renderer_ptr = std::make_unique<deepbound::chunk_renderer_t>((size_t)options.vram_budget_mb * 1024 * 1024); }, {"window"}, affinity_e::main_thread);
 
-  // Load Content
   std::cout << "Loading Content..." << std::endl;
-  deepbound::json_loader_t::load_tiles_from_directory("assets/tiles");
-  deepbound::json_loader_t::load_color_maps("assets/config/color_maps.json");
-  // World generation data is loaded from assets/worldgen/ within the world_generator_t constructor.
-  asset_mgr.load_all_textures_from_registry();
-
-  // World Generation
-  deepbound::world_t world;
-
-  // Renderer
-  deepbound::chunk_renderer_t renderer;
+  if (!startup.run())
+    return 1;
+  std::cout << "Startup:" << std::endl;
+  startup.print_timings(std::cout);
+
+  auto &window = *window_ptr;
+  auto &world = *world_ptr;
+  auto &renderer = *renderer_ptr;
+  if (options.chunk_textures)
+    renderer.set_mode(deepbound::chunk_renderer_t::mode_e::texture_cache);
+  world.set_watch_config(!replaying); // Replays must generate the recorded world
+  if (!options.save_dir.empty() && !replaying && !world.enable_saving(options.save_dir))
+    return 1;
   deepbound::camera_2d_t camera;
+  deepbound::chunk_pipeline_overlay_t pipeline_overlay; // F3
+  bool f3_was_down = false;
   camera.set_position({0.0f, 250.0f}); // Adjusted for new world height/sea level
   camera.set_zoom(0.01f);
 
-  // Setup Zoom Callback
-  window.set_scroll_callback([&camera](double x, double y) { camera.zoom_scroll((float)y); });
+  if (replaying)
+  {
+    camera.set_position(recording.start_position);
+    camera.set_zoom(recording.start_zoom);
+  }
+  else
+  {
+    recording.seed = world.get_seed();
+    recording.keys = {GLFW_KEY_W, GLFW_KEY_A, GLFW_KEY_S, GLFW_KEY_D};
+    recording.start_position = camera.get_position();
+    recording.start_zoom = camera.get_zoom();
+  }
+
+  // Setup Zoom Callback. Steps are applied once per frame so they can be recorded.
+  float scroll_steps = 0.0f;
+  window.set_scroll_callback([&scroll_steps](double /*x*/, double y) { scroll_steps += (y > 0.0) ? 1.0f : (y < 0.0 ? -1.0f : 0.0f); });
 
   float last_time = 0.0f;
+  size_t replay_frame = 0;
+  std::vector<double> frame_ms;
+  std::vector<double> chunk_ms;
+  auto frame_start = std::chrono::steady_clock::now();
+  auto &frame_seconds = deepbound::metrics_t::get().histogram("deepbound_frame_seconds", "Frame time", deepbound::metrics_t::seconds_buckets());
 
   // Main Loop
   while (!window.should_close())
@@ -77,17 +259,42 @@ int main(int argc, char *argv[])
 
     window.update();
 
+    // Input: live (and recorded) or played back
+    deepbound::input_frame_t input;
+    if (replaying)
+    {
+      if (replay_frame >= recording.frames.size())
+        break;
+      input = recording.frames[replay_frame++];
+      delta_time = input.delta_time;
+    }
+    else
+    {
+      input = {delta_time, recording.pack_keys([&](int key) { return window.is_key_pressed(key); }), scroll_steps};
+      if (!options.record_path.empty())
+        recording.frames.push_back(input);
+    }
+    scroll_steps = 0.0f;
+
+    for (int i = 0; i < (int)std::abs(input.scroll); i++)
+      camera.zoom_scroll(input.scroll);
+
     // Input Handling
     float speed = 2.0f * delta_time / camera.get_zoom(); // Adjust speed by zoom
-    if (window.is_key_pressed(GLFW_KEY_W))
+    if (recording.is_down(input, GLFW_KEY_W))
       camera.move({0.0f, speed});
-    if (window.is_key_pressed(GLFW_KEY_S))
+    if (recording.is_down(input, GLFW_KEY_S))
       camera.move({0.0f, -speed});
-    if (window.is_key_pressed(GLFW_KEY_A))
+    if (recording.is_down(input, GLFW_KEY_A))
       camera.move({-speed, 0.0f});
-    if (window.is_key_pressed(GLFW_KEY_D))
+    if (recording.is_down(input, GLFW_KEY_D))
       camera.move({speed, 0.0f});
 
+    bool f3_down = window.is_key_pressed(GLFW_KEY_F3);
+    if (f3_down && !f3_was_down)
+      pipeline_overlay.visible = !pipeline_overlay.visible;
+    f3_was_down = f3_down;
+
     // Update World (Process Async Chunks)
     world.update(delta_time);
 
@@ -159,6 +366,9 @@ int main(int argc, char *argv[])
         {
           ImGui::Text("Tile: <None>");
         }
+        const auto &gpu = renderer.get_residency().get_stats();
+        ImGui::Text("Chunk VRAM: %.1f / %.1f MB (%zu resident)%s", gpu.resident_bytes / 1048576.0, gpu.budget_bytes / 1048576.0, gpu.resident_count,
+                    gpu.over_budget ? " over budget" : "");
         ImGui::End();
       }
     }
@@ -166,19 +376,41 @@ int main(int argc, char *argv[])
     float aspect = (float)window.get_width() / (float)window.get_height();
 
     // Render visible chunks
-    auto visible_chunks = world.get_visible_chunks(camera.get_position(), 4); // Range 4
+    const int view_distance = 4;
+    auto visible_chunks = world.get_visible_chunks(camera.get_position(), view_distance);
 
+    renderer.begin_frame((size_t)(2 * view_distance + 1) * (2 * view_distance + 1));
     for (auto *chunk : visible_chunks)
     {
       renderer.render(*chunk, camera, aspect);
     }
 
+    pipeline_overlay.draw(world, renderer, camera.get_position());
+
     ImGui::Render();
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
     window.swap_buffers();
+
+    auto now = std::chrono::steady_clock::now();
+    double this_frame_ms = std::chrono::duration<double, std::milli>(now - frame_start).count();
+    frame_start = now;
+    frame_seconds.observe(this_frame_ms / 1000.0);
+
+    // Always drained, so long sessions don't accumulate them
+    auto latencies = world.take_chunk_latencies_ms();
+    if (replaying)
+    {
+      frame_ms.push_back(this_frame_ms);
+      chunk_ms.insert(chunk_ms.end(), latencies.begin(), latencies.end());
+    }
   }
 
+  if (replaying)
+    report_replay(frame_ms, chunk_ms, options.report_path);
+  else if (!options.record_path.empty() && recording.save(options.record_path))
+    std::cout << "Recorded " << recording.frames.size() << " frames to " << options.record_path << std::endl;
+
   ImGui_ImplOpenGL3_Shutdown();
   ImGui_ImplGlfw_Shutdown();
   ImGui::DestroyContext();
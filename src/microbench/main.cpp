@@ -0,0 +1,350 @@
+#include "core/assets/asset_manager.hpp"
+#include "core/assets/json_loader.hpp"
+#include "core/assets/texture_atlas.hpp"
+#include "core/common/resource_id.hpp"
+#include "core/content/tile.hpp"
+#include "core/graphics/window.hpp"
+#include "core/worldgen/world.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// Microbenchmarks for hot core primitives, compared against stored baselines.
+//   deepbound_microbench --save-baseline bench/baseline.json   (on a known-good build)
+//   deepbound_microbench --baseline bench/baseline.json        (exit code 1 on regression)
+// Needs a GL context for the atlas benchmarks (hidden window, or --api osmesa/egl) and must run
+// from a directory containing assets/, like the game.
+
+namespace
+{
+struct options_t
+{
+  deepbound::window_t::context_api_e api = deepbound::window_t::context_api_e::native;
+  std::string baseline_path;
+  std::string save_path;
+  std::string filter;
+  double threshold = 10.0; // Percent slower than baseline that counts as a regression
+  int samples = 7;
+  double sample_ms = 20.0; // Minimum duration of one sample
+};
+
+struct benchmark_t
+{
+  std::string name;
+  std::function<void(size_t iterations)> run; // Performs `iterations` operations
+};
+
+struct result_t
+{
+  std::string name;
+  double ns_per_op;     // Median over samples
+  double min_ns_per_op;
+};
+
+// Keeps the optimiser from discarding a benchmark's result
+template <typename T>
+inline void keep(const T &value)
+{
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+auto print_usage() -> void
+{
+  std::cout << "Usage: deepbound_microbench [options]\n"
+            << "  --baseline FILE       Compare against a stored baseline (exit 1 on regression)\n"
+            << "  --save-baseline FILE  Store this run as the new baseline\n"
+            << "  --threshold PCT       Allowed slowdown before flagging (default: 10)\n"
+            << "  --filter TEXT         Only run benchmarks whose name contains TEXT\n"
+            << "  --samples N           Samples per benchmark (default: 7)\n"
+            << "  --api native|egl|osmesa\n";
+}
+
+auto parse_options(int argc, char *argv[], options_t &options) -> bool
+{
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h" || i + 1 >= argc)
+      return false;
+
+    std::string value = argv[++i];
+    if (arg == "--baseline")
+      options.baseline_path = value;
+    else if (arg == "--save-baseline")
+      options.save_path = value;
+    else if (arg == "--threshold")
+      options.threshold = std::atof(value.c_str());
+    else if (arg == "--filter")
+      options.filter = value;
+    else if (arg == "--samples")
+      options.samples = std::max(1, std::atoi(value.c_str()));
+    else if (arg == "--api")
+    {
+      if (value == "native")
+        options.api = deepbound::window_t::context_api_e::native;
+      else if (value == "egl")
+        options.api = deepbound::window_t::context_api_e::egl;
+      else if (value == "osmesa")
+        options.api = deepbound::window_t::context_api_e::osmesa;
+      else
+        return false;
+    }
+    else
+      return false;
+  }
+  return true;
+}
+
+auto measure(const benchmark_t &bench, const options_t &options) -> result_t
+{
+  using clock = std::chrono::steady_clock;
+  auto time_ms = [&](size_t n)
+  {
+    auto start = clock::now();
+    bench.run(n);
+    return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+  };
+
+  // Grow the batch until one sample is long enough to time reliably (this also warms caches)
+  size_t iterations = 1;
+  while (time_ms(iterations) < options.sample_ms && iterations < (1ull << 30))
+    iterations *= 2;
+
+  std::vector<double> per_op;
+  for (int s = 0; s < options.samples; s++)
+    per_op.push_back(time_ms(iterations) * 1e6 / (double)iterations);
+  std::sort(per_op.begin(), per_op.end());
+
+  return {bench.name, per_op[per_op.size() / 2], per_op.front()};
+}
+
+auto read_file(const std::string &path) -> std::string
+{
+  std::ifstream f(path);
+  std::stringstream buffer;
+  buffer << f.rdbuf();
+  return buffer.str();
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+  options_t options;
+  if (!parse_options(argc, argv, options))
+  {
+    print_usage();
+    return 1;
+  }
+
+  deepbound::window_t::properties_t props;
+  props.title = "Deepbound Microbench";
+  props.width = 64;
+  props.height = 64;
+  props.vsync = false;
+  props.visible = false;
+  props.context_api = options.api;
+  props.gl_major = 3;
+  props.gl_minor = 3;
+  deepbound::window_t window(props);
+  if (!window.is_valid())
+    return 1;
+
+  // Content, as the game loads it
+  auto &asset_mgr = deepbound::asset_manager_t::get();
+  asset_mgr.initialize();
+  deepbound::json_loader_t::load_tiles_from_directory("assets/tiles");
+  deepbound::json_loader_t::load_color_maps("assets/config/color_maps.json");
+  asset_mgr.load_all_textures_from_registry();
+
+  std::vector<deepbound::resource_id_t> tile_ids;
+  std::vector<std::string> tile_id_strings;
+  std::vector<deepbound::resource_id_t> texture_ids;
+  for (const auto &[id, def] : deepbound::tile_registry_t::get().get_all_tiles())
+  {
+    tile_ids.push_back(id);
+    tile_id_strings.push_back(id.to_string());
+    for (const auto &[key, tex] : def.textures)
+      texture_ids.push_back(tex);
+  }
+  std::mt19937 rng(1234);
+  std::shuffle(tile_ids.begin(), tile_ids.end(), rng);
+  std::shuffle(texture_ids.begin(), texture_ids.end(), rng);
+
+  // A small fixed-seed world, fully generated up front
+  deepbound::world_t world(12345);
+  const int world_chunks = 4;
+  for (int cx = 0; cx < world_chunks; cx++)
+    for (int cy = 14; cy < 14 + world_chunks; cy++)
+      world.get_chunk(cx, cy);
+
+  std::vector<std::pair<int, int>> tile_positions(4096);
+  std::uniform_int_distribution<int> pos_x(0, world_chunks * deepbound::chunk_t::SIZE - 1);
+  std::uniform_int_distribution<int> pos_y(14 * deepbound::chunk_t::SIZE, (14 + world_chunks) * deepbound::chunk_t::SIZE - 1);
+  for (auto &p : tile_positions)
+    p = {pos_x(rng), pos_y(rng)};
+
+  const std::string tile_json = read_file("assets/tiles/soil/soil.json");
+
+  // Atlas packing on its own: the image is decoded and the ids are built once, outside the timing
+  deepbound::decoded_image_t tile_image;
+  if (!deepbound::decode_image("assets/textures/unknown.png", tile_image))
+  {
+    std::cerr << "Failed to decode assets/textures/unknown.png" << std::endl;
+    return 1;
+  }
+  const int atlas_size = 1024;
+  const size_t atlas_capacity = (size_t)(atlas_size / tile_image.width) * (size_t)(atlas_size / tile_image.height);
+  std::vector<deepbound::resource_id_t> atlas_ids;
+  atlas_ids.reserve(atlas_capacity);
+  for (size_t i = 0; i < atlas_capacity; i++)
+    atlas_ids.emplace_back("deepbound", "bench/" + std::to_string(i));
+
+  std::vector<benchmark_t> benchmarks = {
+      {"world.get_tile_at",
+       [&](size_t n)
+       {
+         for (size_t i = 0; i < n; i++)
+         {
+           const auto &p = tile_positions[i & 4095];
+           keep(world.get_tile_at(p.first, p.second));
+         }
+       }},
+      {"resource_id.construct_string",
+       [&](size_t n)
+       {
+         for (size_t i = 0; i < n; i++)
+         {
+           deepbound::resource_id_t id(tile_id_strings[i % tile_id_strings.size()]);
+           keep(id);
+         }
+       }},
+      {"resource_id.construct_parts",
+       [&](size_t n)
+       {
+         for (size_t i = 0; i < n; i++)
+         {
+           deepbound::resource_id_t id("deepbound", tile_ids[i % tile_ids.size()].get_path());
+           keep(id);
+         }
+       }},
+      {"resource_id.equal",
+       [&](size_t n)
+       {
+         for (size_t i = 0; i < n; i++)
+         {
+           bool eq = tile_ids[i % tile_ids.size()] == tile_ids[(i * 7 + 1) % tile_ids.size()];
+           keep(eq);
+         }
+       }},
+      {"resource_id.less",
+       [&](size_t n)
+       {
+         for (size_t i = 0; i < n; i++)
+         {
+           bool lt = tile_ids[i % tile_ids.size()] < tile_ids[(i * 7 + 1) % tile_ids.size()];
+           keep(lt);
+         }
+       }},
+      {"tile_registry.get_tile",
+       [&](size_t n)
+       {
+         auto &registry = deepbound::tile_registry_t::get();
+         for (size_t i = 0; i < n; i++)
+           keep(registry.get_tile(tile_ids[i % tile_ids.size()]));
+       }},
+      {"asset_manager.get_texture_uvs",
+       [&](size_t n)
+       {
+         for (size_t i = 0; i < n; i++)
+         {
+           auto uvs = asset_mgr.get_texture_uvs("tiles", texture_ids[i % texture_ids.size()]);
+           keep(uvs);
+         }
+       }},
+      {"json.standardize_and_parse",
+       [&](size_t n)
+       {
+         for (size_t i = 0; i < n; i++)
+         {
+           auto j = nlohmann::json::parse(deepbound::standardize_json(tile_json), nullptr, true, true);
+           keep(j);
+         }
+       }},
+      {"texture_atlas.add_image",
+       [&](size_t n)
+       {
+         // unknown.png is 8x8: a fresh 1024x1024 atlas holds 16384 of them
+         std::unique_ptr<deepbound::texture_atlas_t> atlas;
+         for (size_t i = 0; i < n; i++)
+         {
+           if (i % atlas_capacity == 0)
+             atlas = std::make_unique<deepbound::texture_atlas_t>(atlas_size, atlas_size);
+           keep(atlas->add_image(atlas_ids[i % atlas_capacity], tile_image));
+         }
+       }},
+  };
+
+  nlohmann::json baseline;
+  if (!options.baseline_path.empty())
+  {
+    std::ifstream file(options.baseline_path);
+    if (!file.is_open())
+    {
+      std::cerr << "Failed to open baseline: " << options.baseline_path << std::endl;
+      return 1;
+    }
+    file >> baseline;
+  }
+
+  std::cout << std::left << std::setw(32) << "benchmark" << std::right << std::setw(12) << "ns/op" << std::setw(12) << "min" << std::setw(12) << "baseline"
+            << std::setw(10) << "delta" << std::endl;
+
+  std::vector<result_t> results;
+  int regressions = 0;
+  for (const auto &bench : benchmarks)
+  {
+    if (!options.filter.empty() && bench.name.find(options.filter) == std::string::npos)
+      continue;
+
+    auto r = measure(bench, options);
+    results.push_back(r);
+
+    std::cout << std::left << std::setw(32) << r.name << std::right << std::fixed << std::setprecision(1) << std::setw(12) << r.ns_per_op << std::setw(12) << r.min_ns_per_op;
+    if (baseline.contains("benchmarks") && baseline["benchmarks"].contains(r.name))
+    {
+      double base = baseline["benchmarks"][r.name].value("ns_per_op", 0.0);
+      double delta = base > 0.0 ? (r.ns_per_op - base) / base * 100.0 : 0.0;
+      bool regressed = delta > options.threshold;
+      regressions += regressed ? 1 : 0;
+      std::cout << std::setw(12) << base << std::setw(9) << std::showpos << delta << "%" << std::noshowpos << (regressed ? "  REGRESSION" : "");
+    }
+    std::cout << std::endl;
+  }
+
+  if (!options.save_path.empty())
+  {
+    nlohmann::json out;
+    for (const auto &r : results)
+      out["benchmarks"][r.name] = {{"ns_per_op", r.ns_per_op}, {"min_ns_per_op", r.min_ns_per_op}};
+    std::ofstream file(options.save_path);
+    file << out.dump(2) << std::endl;
+    std::cout << "Baseline saved to " << options.save_path << std::endl;
+  }
+
+  if (regressions > 0)
+  {
+    std::cout << regressions << " regression(s) over " << options.threshold << "%" << std::endl;
+    return 1;
+  }
+  return 0;
+}
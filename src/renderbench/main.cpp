@@ -0,0 +1,263 @@
+#include "core/assets/asset_manager.hpp"
+#include "core/assets/json_loader.hpp"
+#include "core/common/perf_stats.hpp"
+#include "core/graphics/chunk_renderer.hpp"
+#include "core/graphics/window.hpp"
+#include "core/worldgen/world.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <GLFW/glfw3.h>
+#include <glad/glad.h>
+#include <nlohmann/json.hpp>
+
+// Renderer benchmark for machines without a GPU. Runs on a hidden window or a fully offscreen
+// OSMesa/EGL context (Mesa llvmpipe), flies scripted camera paths over pregenerated chunks and
+// times chunk_renderer_t's CPU submission separately from the driver's work (glFinish).
+// Run from a directory containing assets/, like the game.
+
+namespace
+{
+struct options_t
+{
+  deepbound::window_t::context_api_e api = deepbound::window_t::context_api_e::native;
+  int width = 1280;
+  int height = 720;
+  int frames = 240; // Per path and mode
+  int seed = 12345;
+  int view_distance = 4; // The game's
+  std::string report_path;
+};
+
+struct camera_path_t
+{
+  std::string name;
+  std::function<void(float t, deepbound::camera_2d_t &camera)> at; // t in [0, 1]
+};
+
+// Ways of driving the renderer. "cached" is steady state; "rebuild" dirties every visible chunk
+// each frame so mesh building is part of the cost; "tight" caps chunk VRAM well below the visible
+// set's needs, so paths keep evicting and re-uploading; "texture" draws chunks from their cached
+// textures, one quad each, at whatever resolution lets the whole view fit the default budget.
+struct render_mode_t
+{
+  std::string name;
+  bool rebuild_meshes;
+  size_t vram_budget_bytes;
+  deepbound::chunk_renderer_t::mode_e renderer_mode = deepbound::chunk_renderer_t::mode_e::mesh;
+};
+
+auto print_usage() -> void
+{
+  std::cout << "Usage: deepbound_renderbench [options]\n"
+            << "  --api native|egl|osmesa  Context creation API (default: native, hidden window)\n"
+            << "  --size WxH               Framebuffer size (default: 1280x720)\n"
+            << "  --frames N               Frames per camera path and mode (default: 240)\n"
+            << "  --seed N                 World seed (default: 12345)\n"
+            << "  --report FILE            Also write results as JSON\n";
+}
+
+auto parse_options(int argc, char *argv[], options_t &options) -> bool
+{
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h" || i + 1 >= argc)
+      return false;
+
+    std::string value = argv[++i];
+    if (arg == "--api")
+    {
+      if (value == "native")
+        options.api = deepbound::window_t::context_api_e::native;
+      else if (value == "egl")
+        options.api = deepbound::window_t::context_api_e::egl;
+      else if (value == "osmesa")
+        options.api = deepbound::window_t::context_api_e::osmesa;
+      else
+        return false;
+    }
+    else if (arg == "--size")
+    {
+      if (std::sscanf(value.c_str(), "%dx%d", &options.width, &options.height) != 2)
+        return false;
+    }
+    else if (arg == "--frames")
+      options.frames = std::max(1, std::atoi(value.c_str()));
+    else if (arg == "--seed")
+      options.seed = std::atoi(value.c_str());
+    else if (arg == "--report")
+      options.report_path = value;
+    else
+      return false;
+  }
+  return true;
+}
+
+auto summary_json(const deepbound::perf_summary_t &p) -> nlohmann::json
+{
+  return {{"mean", p.mean}, {"p50", p.p50}, {"p90", p.p90}, {"p99", p.p99}, {"max", p.max}};
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+  options_t options;
+  if (!parse_options(argc, argv, options))
+  {
+    print_usage();
+    return 1;
+  }
+
+  deepbound::window_t::properties_t props;
+  props.title = "Deepbound Render Bench";
+  props.width = options.width;
+  props.height = options.height;
+  props.vsync = false;
+  props.visible = false;
+  props.context_api = options.api;
+  props.gl_major = 3; // llvmpipe doesn't always offer 4.6; the renderer only needs 3.3
+  props.gl_minor = 3;
+
+  deepbound::window_t window(props);
+  if (!window.is_valid())
+    return 1;
+
+  std::cout << "GL: " << (const char *)glGetString(GL_RENDERER) << " / " << (const char *)glGetString(GL_VERSION) << std::endl;
+
+  auto &asset_mgr = deepbound::asset_manager_t::get();
+  asset_mgr.initialize();
+  deepbound::json_loader_t::load_tiles_from_directory("assets/tiles");
+  deepbound::json_loader_t::load_color_maps("assets/config/color_maps.json");
+  asset_mgr.load_all_textures_from_registry();
+
+  deepbound::world_t world(options.seed);
+  deepbound::chunk_renderer_t renderer;
+  deepbound::camera_2d_t camera;
+  const float aspect = (float)options.width / (float)options.height;
+
+  // Scripted paths, all inside the pregenerated area below
+  const std::vector<camera_path_t> paths = {
+      {"pan",
+       [](float t, deepbound::camera_2d_t &c)
+       {
+         c.set_position({-512.0f + 1024.0f * t, 500.0f});
+         c.set_zoom(0.02f);
+       }},
+      {"dive",
+       [](float t, deepbound::camera_2d_t &c)
+       {
+         c.set_position({0.0f, 700.0f - 500.0f * t});
+         c.set_zoom(0.02f);
+       }},
+      {"zoom",
+       [](float t, deepbound::camera_2d_t &c)
+       {
+         c.set_position({0.0f, 480.0f});
+         c.set_zoom(0.05f * std::pow(0.2f, t));
+       }},
+  };
+  const size_t default_budget = 256ull * 1024 * 1024;
+  const std::vector<render_mode_t> modes = {{"cached", false, default_budget},
+                                            {"rebuild", true, default_budget},
+                                            {"tight", false, 4ull * 1024 * 1024},
+                                            {"texture", false, default_budget, deepbound::chunk_renderer_t::mode_e::texture_cache}};
+
+  // Pregenerate synchronously so generation never lands inside a timed frame
+  {
+    auto start = std::chrono::steady_clock::now();
+    int count = 0;
+    for (int cx = -512 / deepbound::chunk_t::SIZE - options.view_distance - 1; cx <= 512 / deepbound::chunk_t::SIZE + options.view_distance + 1; cx++)
+    {
+      for (int cy = 0; cy <= 32; cy++)
+      {
+        world.get_chunk(cx, cy);
+        count++;
+      }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Pregenerated " << count << " chunks in " << seconds << "s" << std::endl;
+  }
+
+  nlohmann::json report = nlohmann::json::array();
+  for (const auto &mode : modes)
+  {
+    for (const auto &path : paths)
+    {
+      std::vector<double> submit_ms;
+      std::vector<double> driver_ms;
+      size_t chunk_draws = 0;
+
+      // Every run starts with nothing resident
+      auto &residency = renderer.get_residency();
+      residency.clear();
+      residency.set_budget(mode.vram_budget_bytes);
+      renderer.set_mode(mode.renderer_mode);
+      const auto before = residency.get_stats();
+
+      for (int f = 0; f < options.frames; f++)
+      {
+        path.at((float)f / (float)std::max(1, options.frames - 1), camera);
+        auto visible = world.get_visible_chunks(camera.get_position(), options.view_distance);
+        if (mode.rebuild_meshes)
+        {
+          for (auto *chunk : visible)
+            chunk->mesh_dirty = true;
+        }
+
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        auto t0 = std::chrono::steady_clock::now();
+        renderer.begin_frame((size_t)(2 * options.view_distance + 1) * (2 * options.view_distance + 1));
+        for (auto *chunk : visible)
+          renderer.render(*chunk, camera, aspect);
+        auto t1 = std::chrono::steady_clock::now();
+        glFinish();
+        auto t2 = std::chrono::steady_clock::now();
+        window.swap_buffers();
+
+        submit_ms.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+        driver_ms.push_back(std::chrono::duration<double, std::milli>(t2 - t1).count());
+        chunk_draws += visible.size();
+      }
+
+      auto submit = deepbound::summarize(submit_ms);
+      auto driver = deepbound::summarize(driver_ms);
+      const auto &gpu = residency.get_stats();
+      const size_t uploads = gpu.uploads - before.uploads;
+      const size_t evictions = gpu.evictions - before.evictions;
+      std::cout << mode.name << "/" << path.name << ": " << chunk_draws / options.frames << " chunks/frame"
+                << "  submit ms p50 " << submit.p50 << " p99 " << submit.p99 << "  driver ms p50 " << driver.p50 << " p99 " << driver.p99 << "  uploads " << uploads
+                << " evictions " << evictions << " peak MB " << gpu.peak_bytes / 1048576.0;
+      if (mode.renderer_mode == deepbound::chunk_renderer_t::mode_e::texture_cache)
+        std::cout << " texels/tile " << renderer.get_tile_texels();
+      std::cout << std::endl;
+
+      report.push_back({{"mode", mode.name},
+                        {"path", path.name},
+                        {"submit_ms", summary_json(submit)},
+                        {"driver_ms", summary_json(driver)},
+                        {"uploads", uploads},
+                        {"evictions", evictions},
+                        {"peak_vram_bytes", gpu.peak_bytes}});
+      if (mode.renderer_mode == deepbound::chunk_renderer_t::mode_e::texture_cache)
+        report.back()["tile_texels"] = renderer.get_tile_texels();
+    }
+  }
+
+  if (!options.report_path.empty())
+  {
+    std::ofstream file(options.report_path);
+    file << report.dump(2) << std::endl;
+  }
+
+  return 0;
+}
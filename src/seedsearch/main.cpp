@@ -0,0 +1,315 @@
+#include "core/assets/json_loader.hpp"
+#include "core/worldgen/world_generator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Headless seed search over the surface column pipeline (continental, landforms, climate).
+// Nothing is generated below the surface and no chunks are built, so each seed costs a few
+// hundred batched column samples at most.
+
+namespace
+{
+struct options_t
+{
+  std::string assets = "assets";
+  long long start = 1;
+  long long count = 100000;
+  int limit = 10;
+  int threads = 0;
+  int step = 8; // Tiles between sampled columns when scanning for features
+
+  bool land_spawn = false;
+  int ocean_within = -1; // Search radius, -1 = don't care
+  int ocean_width = 256;
+  int ocean_depth = 20; // Tiles below sea level to count as open ocean
+  std::string biome;
+  int biome_within = 1024;
+
+  bool profile_noise = false; // Time the worldgen noise graphs instead of searching
+};
+
+struct match_t
+{
+  int seed;
+  float spawn_height;
+  int ocean_distance; // -1 if not searched
+  int biome_distance;
+};
+
+auto print_usage() -> void
+{
+  std::cout << "Usage: deepbound_seedsearch [options]\n"
+            << "  --assets DIR           Asset directory (default: assets)\n"
+            << "  --start N              First seed to test (default: 1)\n"
+            << "  --count N              Number of seeds to test (default: 100000)\n"
+            << "  --limit N              Stop after N matches (default: 10)\n"
+            << "  --threads N            Worker threads (default: hardware concurrency)\n"
+            << "  --step N               Column spacing for feature scans (default: 8)\n"
+            << "  --land-spawn           Spawn column must be above sea level\n"
+            << "  --ocean-within N       An ocean must start within N tiles of spawn\n"
+            << "  --ocean-width N        Minimum ocean width in tiles (default: 256)\n"
+            << "  --ocean-depth N        Minimum depth below sea level (default: 20)\n"
+            << "  --biome NAME           A block layer with this name must occur near spawn\n"
+            << "  --biome-within N       Search radius for --biome (default: 1024)\n"
+            << "  --profile-noise        Time every worldgen noise graph and exit (3 if over budget)\n";
+}
+
+auto parse_options(int argc, char *argv[], options_t &options) -> bool
+{
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    auto next = [&]() -> const char *
+    {
+      if (i + 1 >= argc)
+      {
+        std::cerr << "Missing value for " << arg << std::endl;
+        std::exit(1);
+      }
+      return argv[++i];
+    };
+
+    if (arg == "--assets")
+      options.assets = next();
+    else if (arg == "--start")
+      options.start = std::atoll(next());
+    else if (arg == "--count")
+      options.count = std::atoll(next());
+    else if (arg == "--limit")
+      options.limit = std::atoi(next());
+    else if (arg == "--threads")
+      options.threads = std::atoi(next());
+    else if (arg == "--step")
+      options.step = std::max(1, std::atoi(next()));
+    else if (arg == "--land-spawn")
+      options.land_spawn = true;
+    else if (arg == "--ocean-within")
+      options.ocean_within = std::atoi(next());
+    else if (arg == "--ocean-width")
+      options.ocean_width = std::atoi(next());
+    else if (arg == "--ocean-depth")
+      options.ocean_depth = std::atoi(next());
+    else if (arg == "--biome")
+      options.biome = next();
+    else if (arg == "--biome-within")
+      options.biome_within = std::atoi(next());
+    else if (arg == "--profile-noise")
+      options.profile_noise = true;
+    else if (arg == "--help" || arg == "-h")
+      return false;
+    else
+    {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+class seed_tester_t
+{
+public:
+  seed_tester_t(deepbound::world_generator_t &generator, const options_t &options, int biome_layer)
+      : m_generator(generator), m_options(options), m_biome_layer(biome_layer), m_sea_level((float)generator.get_sea_level())
+  {
+  }
+
+  // Cheapest checks first; any failure rejects the seed immediately
+  auto test(int seed, match_t &out) -> bool
+  {
+    out = {seed, 0.0f, -1, -1};
+
+    // Spawn: a few columns around x = 0
+    const int spawn_span = 16;
+    m_columns.resize(spawn_span);
+    m_generator.sample_columns(seed, -spawn_span / 2, spawn_span, 1, m_columns.data());
+    float lowest = m_columns[0].height;
+    for (const auto &c : m_columns)
+      lowest = std::min(lowest, c.height);
+    out.spawn_height = m_columns[spawn_span / 2].height;
+    if (m_options.land_spawn && lowest <= m_sea_level)
+      return false;
+
+    if (m_biome_layer >= 0)
+    {
+      out.biome_distance = find_outward(seed, m_options.biome_within, [&](const deepbound::ColumnSample &c) { return c.block_layer == m_biome_layer; });
+      if (out.biome_distance < 0)
+        return false;
+    }
+
+    if (m_options.ocean_within >= 0)
+    {
+      out.ocean_distance = find_ocean(seed);
+      if (out.ocean_distance < 0)
+        return false;
+    }
+
+    return true;
+  }
+
+private:
+  // Distance from spawn of the nearest sampled column matching `pred`, -1 if none within radius
+  template <typename F>
+  auto find_outward(int seed, int radius, F &&pred) -> int
+  {
+    const int step = m_options.step;
+    const int n = radius / step;
+    m_columns.resize(2 * n + 1);
+    m_generator.sample_columns(seed, -n * step, 2 * n + 1, step, m_columns.data());
+
+    for (int d = 0; d <= n; d++)
+    {
+      if (pred(m_columns[n + d]) || pred(m_columns[n - d]))
+        return d * step;
+    }
+    return -1;
+  }
+
+  // Nearest start of a run of ocean columns at least ocean_width wide, on either side of spawn
+  auto find_ocean(int seed) -> int
+  {
+    const int step = m_options.step;
+    const int run_needed = std::max(1, m_options.ocean_width / step);
+    const int n = m_options.ocean_within / step;
+    const float ocean_level = m_sea_level - (float)m_options.ocean_depth;
+
+    // The run may extend past the radius, only its start has to be inside it
+    const int total = n + run_needed;
+    m_columns.resize(2 * total + 1);
+    m_generator.sample_columns(seed, -total * step, 2 * total + 1, step, m_columns.data());
+
+    int best = -1;
+    for (int dir : {1, -1})
+    {
+      int run = 0;
+      for (int d = 0; d <= total; d++)
+      {
+        run = (m_columns[total + dir * d].height < ocean_level) ? run + 1 : 0;
+        if (run >= run_needed)
+        {
+          int start = (d - run + 1) * step;
+          if (start <= m_options.ocean_within && (best < 0 || start < best))
+            best = start;
+          break;
+        }
+      }
+    }
+    return best;
+  }
+
+  deepbound::world_generator_t &m_generator;
+  const options_t &m_options;
+  int m_biome_layer;
+  float m_sea_level;
+  std::vector<deepbound::ColumnSample> m_columns;
+};
+} // namespace
+
+int main(int argc, char *argv[])
+{
+  options_t options;
+  if (!parse_options(argc, argv, options))
+  {
+    print_usage();
+    return 1;
+  }
+
+  // Tiles are only needed so block layers resolve without warnings
+  deepbound::json_loader_t::load_tiles_from_directory(options.assets + "/tiles");
+
+  deepbound::world_generator_t generator(nullptr);
+  generator.load_config(options.assets + "/worldgen/landforms.json");
+  generator.load_block_layers(options.assets + "/worldgen/blocklayers.json");
+
+  if (options.profile_noise)
+  {
+    // Subsurface noises aren't needed for the search itself, only for profiling
+    generator.load_caves(options.assets + "/worldgen/caves.json");
+    generator.load_provinces(options.assets + "/worldgen/provinces.json");
+    return generator.profile_noise_graphs() ? 0 : 3;
+  }
+
+  int biome_layer = -1;
+  if (!options.biome.empty())
+  {
+    const auto &layers = generator.get_block_layers();
+    auto it = std::find_if(layers.begin(), layers.end(), [&](const deepbound::BlockLayer &l) { return l.name == options.biome; });
+    if (it == layers.end())
+    {
+      std::cerr << "Unknown biome '" << options.biome << "'. Available:";
+      for (const auto &l : layers)
+        std::cerr << " '" << l.name << "'";
+      std::cerr << std::endl;
+      return 1;
+    }
+    biome_layer = (int)(it - layers.begin());
+  }
+
+  int thread_count = options.threads > 0 ? options.threads : (int)std::max(1u, std::thread::hardware_concurrency());
+
+  std::atomic<long long> next_seed{options.start};
+  std::atomic<long long> tested{0};
+  std::atomic<bool> done{false};
+  std::mutex results_mutex;
+  std::vector<match_t> matches;
+
+  const long long end_seed = options.start + options.count;
+  const long long batch = 64;
+  auto begin_time = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < thread_count; t++)
+  {
+    workers.emplace_back(
+        [&]()
+        {
+          seed_tester_t tester(generator, options, biome_layer);
+          while (!done)
+          {
+            long long first = next_seed.fetch_add(batch);
+            if (first >= end_seed)
+              break;
+            long long last = std::min(first + batch, end_seed);
+
+            for (long long seed = first; seed < last && !done; seed++)
+            {
+              match_t match;
+              if (tester.test((int)seed, match))
+              {
+                std::lock_guard<std::mutex> lock(results_mutex);
+                matches.push_back(match);
+                std::cout << "Match: seed " << match.seed << " spawn_height " << match.spawn_height;
+                if (match.ocean_distance >= 0)
+                  std::cout << " ocean_at " << match.ocean_distance;
+                if (match.biome_distance >= 0)
+                  std::cout << " biome_at " << match.biome_distance;
+                std::cout << std::endl;
+                if (options.limit > 0 && (int)matches.size() >= options.limit)
+                  done = true;
+              }
+              tested++;
+            }
+          }
+        });
+  }
+  for (auto &w : workers)
+    w.join();
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin_time).count();
+  std::sort(matches.begin(), matches.end(), [](const match_t &a, const match_t &b) { return a.seed < b.seed; });
+
+  std::cout << "Tested " << tested << " seeds in " << seconds << "s (" << (seconds > 0.0 ? (double)tested / seconds : 0.0) << " seeds/s) on " << thread_count
+            << " threads. " << matches.size() << " matches:";
+  for (const auto &m : matches)
+    std::cout << " " << m.seed;
+  std::cout << std::endl;
+
+  return matches.empty() ? 2 : 0;
+}